@@ -0,0 +1,307 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "c_buffer.h"
+#include "c_buffer_inline.h"
+#include "c_buffer_crc.h"
+
+// Output is one CSV line per case:
+// case,mode,backend,buffer_size,chunk_size,fill_percent,ops,bytes,ns_per_op,mb_per_s
+// backend is memcpy, or word_copy in NO_MEMCPY builds
+
+#define MAX_BUFFER_SIZE (16 * 1024 * 1024)
+#define DEFAULT_MIN_TIME_MS 20
+#define SPSC_THREADED_BYTES (1U << 24)
+
+typedef int (*benchInit_t)(cBuffer_t *inst, uint8_t *buffer, size_t size);
+
+typedef struct {
+    const char  *name;
+    benchInit_t  init;
+} benchMode_t;
+
+typedef struct {
+    cBuffer_t cb;
+    size_t    size;
+    size_t    chunk;
+    size_t    fill;
+} benchCtx_t;
+
+// Run the case once, returns the number of bytes moved
+typedef uint64_t (*benchCase_t)(benchCtx_t *ctx, uint64_t ops);
+
+static uint8_t *main_buffer;
+static uint8_t *chunk_buffer;
+static uint32_t min_time_ms = DEFAULT_MIN_TIME_MS;
+static volatile uint32_t sink;
+
+#ifdef NO_MEMCPY
+static const char *const backend = "word_copy";
+#else
+static const char *const backend = "memcpy";
+#endif
+
+static int initClassic(cBuffer_t *inst, uint8_t *buffer, size_t size) {
+    return cBufferInit(inst, buffer, size);
+}
+
+static int initPow2(cBuffer_t *inst, uint8_t *buffer, size_t size) {
+    return cBufferInitPow2(inst, buffer, size);
+}
+
+static int initSpsc(cBuffer_t *inst, uint8_t *buffer, size_t size) {
+    return cBufferInitSpsc(inst, buffer, size);
+}
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Place tail at an offset so that the next write of fill bytes starts there
+static void placeTail(benchCtx_t *ctx, size_t offset) {
+    cBufferClear(&ctx->cb);
+    cBufferCommitWrite(&ctx->cb, offset);
+    cBufferEmptyRead(&ctx->cb, offset);
+}
+
+static uint64_t caseAppendReadByte(benchCtx_t *ctx, uint64_t ops) {
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferAppendByte(&ctx->cb, (uint8_t)i);
+        acc += cBufferReadByte(&ctx->cb);
+    }
+    sink = acc;
+    return ops;
+}
+
+static uint64_t caseAppendReadByteUnchecked(benchCtx_t *ctx, uint64_t ops) {
+    uint32_t acc = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferAppendByteUnchecked(&ctx->cb, (uint8_t)i);
+        acc += cBufferReadByteUnchecked(&ctx->cb);
+    }
+    sink = acc;
+    return ops;
+}
+
+static uint64_t caseAppendReadBulk(benchCtx_t *ctx, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferAppend(&ctx->cb, chunk_buffer, ctx->chunk);
+        cBufferReadBytes(&ctx->cb, chunk_buffer, ctx->chunk);
+    }
+    return ops * ctx->chunk;
+}
+
+static uint64_t caseAppendReadBulkUnwrapped(benchCtx_t *ctx, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferAppend(&ctx->cb, chunk_buffer, ctx->chunk);
+        cBufferReadAll(&ctx->cb, chunk_buffer, ctx->chunk);
+    }
+    return ops * ctx->chunk;
+}
+
+static uint64_t casePrependRead(benchCtx_t *ctx, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferPrepend(&ctx->cb, chunk_buffer, ctx->chunk);
+        cBufferReadBytes(&ctx->cb, chunk_buffer, ctx->chunk);
+    }
+    return ops * ctx->chunk;
+}
+
+static uint64_t casePeek(benchCtx_t *ctx, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferPeek(&ctx->cb, 0, chunk_buffer, ctx->chunk);
+    }
+    return ops * ctx->chunk;
+}
+
+static uint64_t caseUint32(benchCtx_t *ctx, uint64_t ops) {
+    uint32_t acc = 0;
+    uint32_t value;
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferAppendUint32(&ctx->cb, (uint32_t)i);
+        cBufferReadUint32(&ctx->cb, &value);
+        acc += value;
+    }
+    sink = acc;
+    return ops * sizeof(uint32_t);
+}
+
+static uint64_t caseContiguate(benchCtx_t *ctx, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        // Recreate the wrap, the data is split in the middle of the array
+        placeTail(ctx, ctx->size - ctx->fill / 2);
+        cBufferCommitWrite(&ctx->cb, ctx->fill);
+        cBufferContiguate(&ctx->cb);
+    }
+    return ops * ctx->fill;
+}
+
+static uint64_t caseFind(benchCtx_t *ctx, uint64_t ops) {
+    int32_t acc = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        acc += cBufferFind(&ctx->cb, 0xFF, 0);
+    }
+    sink = (uint32_t)acc;
+    return ops * ctx->fill;
+}
+
+static uint64_t caseCrc32(benchCtx_t *ctx, uint64_t ops) {
+    uint32_t crc = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        cBufferCrc32(&ctx->cb, 0, ctx->fill, crc, &crc);
+    }
+    sink = crc;
+    return ops * ctx->fill;
+}
+
+static void *spscProducer(void *arg) {
+    cBuffer_t *cb = (cBuffer_t *)arg;
+    uint32_t sent = 0;
+
+    while (sent < SPSC_THREADED_BYTES) {
+        if (cBufferAppendByte(cb, (uint8_t)sent) == 1) {
+            sent++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+// Producer and consumer on separate threads, shows the cost of sharing the indexes
+static void runSpscThreaded(size_t size) {
+    cBuffer_t cb;
+    pthread_t producer;
+    uint32_t received = 0;
+    uint32_t acc = 0;
+
+    if (cBufferInitSpsc(&cb, main_buffer, size) != C_BUFFER_SUCCESS) {
+        return;
+    }
+
+    uint64_t start = nowNs();
+    pthread_create(&producer, NULL, spscProducer, &cb);
+    while (received < SPSC_THREADED_BYTES) {
+        if (!cBufferEmpty(&cb)) {
+            acc += cBufferReadByte(&cb);
+            received++;
+        } else {
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    uint64_t elapsed = nowNs() - start;
+    sink = acc;
+
+    printf("spsc_threaded_byte,spsc,%s,%zu,1,0,%u,%u,%.2f,%.1f\n", backend, size, received, received,
+           (double)elapsed / received, ((double)received / (1024.0 * 1024.0)) / ((double)elapsed / 1e9));
+    fflush(stdout);
+}
+
+static void runCase(const char *name, benchCase_t fn, const benchMode_t *mode, size_t size, size_t chunk,
+                    size_t fill_percent, size_t start_offset) {
+    benchCtx_t ctx;
+    if (mode->init(&ctx.cb, main_buffer, size) != C_BUFFER_SUCCESS) {
+        return;
+    }
+
+    ctx.size  = size;
+    ctx.chunk = chunk;
+    ctx.fill  = cBufferAvailableForWrite(&ctx.cb) * fill_percent / 100;
+
+    // Prepare the data for cases that work on a filled buffer
+    placeTail(&ctx, start_offset);
+    if (fn == casePeek || fn == caseFind || fn == caseCrc32) {
+        memset(main_buffer, 0, size);
+        cBufferCommitWrite(&ctx.cb, ctx.fill);
+    } else if (fn == casePrependRead) {
+        // An empty classic buffer is reset by cBufferPrepend, keep one byte stored
+        cBufferCommitWrite(&ctx.cb, 1);
+    }
+
+    // Grow the number of operations until the run is long enough to time
+    uint64_t ops = 1;
+    uint64_t elapsed = 0;
+    uint64_t bytes = 0;
+    while (1) {
+        uint64_t start = nowNs();
+        bytes = fn(&ctx, ops);
+        elapsed = nowNs() - start;
+        if (elapsed >= (uint64_t)min_time_ms * 1000000ULL || ops >= ((uint64_t)1 << 40)) {
+            break;
+        }
+        ops *= 2;
+    }
+
+    double ns_per_op = (double)elapsed / (double)ops;
+    double mb_per_s  = elapsed ? ((double)bytes / (1024.0 * 1024.0)) / ((double)elapsed / 1e9) : 0.0;
+
+    printf("%s,%s,%s,%zu,%zu,%zu,%" PRIu64 ",%" PRIu64 ",%.2f,%.1f\n", name, mode->name, backend, size, chunk,
+           fill_percent, ops, bytes, ns_per_op, mb_per_s);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    static const benchMode_t modes[] = {
+        {"classic", initClassic},
+        {"pow2",    initPow2},
+        {"spsc",    initSpsc},
+    };
+    static const size_t sizes[] = {16, 256, 4096, 65536, 1024 * 1024, MAX_BUFFER_SIZE};
+    static const size_t fills[] = {25, 50, 90};
+
+    if (argc > 1) {
+        min_time_ms = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+
+    main_buffer  = malloc(MAX_BUFFER_SIZE);
+    chunk_buffer = malloc(MAX_BUFFER_SIZE);
+    if (main_buffer == NULL || chunk_buffer == NULL) {
+        fprintf(stderr, "Failed to allocate benchmark buffers\n");
+        return 1;
+    }
+    memset(chunk_buffer, 0xA5, MAX_BUFFER_SIZE);
+
+    printf("case,mode,backend,buffer_size,chunk_size,fill_percent,ops,bytes,ns_per_op,mb_per_s\n");
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t size  = sizes[s];
+            size_t chunk = size / 4;
+
+            runCase("append_read_byte", caseAppendReadByte, &modes[m], size, 1, 0, 0);
+            runCase("append_read_byte_unchecked", caseAppendReadByteUnchecked, &modes[m], size, 1, 0, 0);
+            runCase("uint32_append_read", caseUint32, &modes[m], size, 4, 0, size - 2);
+            runCase("bulk_unwrapped", caseAppendReadBulkUnwrapped, &modes[m], size, chunk, 0, 0);
+
+            // Start next to the end of the array so every fourth chunk wraps
+            runCase("bulk_wrapped", caseAppendReadBulk, &modes[m], size, chunk, 0, size - chunk / 2);
+            // Tail stays at chunk / 2 behind a stored byte so every prepend wraps
+            runCase("prepend_read", casePrependRead, &modes[m], size, chunk, 0, chunk / 2);
+            runCase("peek", casePeek, &modes[m], size, chunk, 50, size / 2);
+            runCase("find_miss", caseFind, &modes[m], size, 0, 90, size / 2);
+            runCase("crc32", caseCrc32, &modes[m], size, 0, 90, size / 2);
+
+            for (size_t f = 0; f < sizeof(fills) / sizeof(fills[0]); f++) {
+                runCase("contiguate", caseContiguate, &modes[m], size, 0, fills[f], 0);
+            }
+        }
+    }
+
+    runSpscThreaded(4096);
+    runSpscThreaded(65536);
+
+    free(main_buffer);
+    free(chunk_buffer);
+
+    return 0;
+}
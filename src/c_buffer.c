@@ -26,10 +26,11 @@
  * SOFTWARE.
 */
 #include "c_buffer.h"
+#include "c_buffer_inline.h"
+#include "c_buffer_stats.h"
 #include "string.h"
 #include <stdio.h>
 
-#define MODULO_INC(value, increment, modulus) (((value) + (increment)) % (modulus))
 #ifndef LOG
 #define LOG(f_, ...) printf((f_), ##__VA_ARGS__)
 #endif
@@ -38,9 +39,295 @@
 #define LOG_DEBUG(f_, ...)// printf((f_), ##__VA_ARGS__)
 #endif
 
-static inline size_t MODULO_DEC(size_t value, size_t decrement, size_t modulus)
+#if defined(__GNUC__) || defined(__clang__)
+#define BSWAP16(x) __builtin_bswap16(x)
+#define BSWAP32(x) __builtin_bswap32(x)
+#define BSWAP64(x) __builtin_bswap64(x)
+#else
+static inline uint16_t BSWAP16(uint16_t x)
+{
+    return (uint16_t)((x << 8) | (x >> 8));
+}
+
+static inline uint32_t BSWAP32(uint32_t x)
+{
+    return ((uint32_t)BSWAP16((uint16_t)x) << 16) | BSWAP16((uint16_t)(x >> 16));
+}
+
+static inline uint64_t BSWAP64(uint64_t x)
+{
+    return ((uint64_t)BSWAP32((uint32_t)x) << 32) | BSWAP32((uint32_t)(x >> 32));
+}
+#endif
+
+// Convert between host and wire byte order, the conversion is its own inverse
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define HOST_TO_BE16(x) (x)
+#define HOST_TO_BE32(x) (x)
+#define HOST_TO_BE64(x) (x)
+#define HOST_TO_LE16(x) BSWAP16(x)
+#define HOST_TO_LE32(x) BSWAP32(x)
+#define HOST_TO_LE64(x) BSWAP64(x)
+#else
+#define HOST_TO_BE16(x) BSWAP16(x)
+#define HOST_TO_BE32(x) BSWAP32(x)
+#define HOST_TO_BE64(x) BSWAP64(x)
+#define HOST_TO_LE16(x) (x)
+#define HOST_TO_LE32(x) (x)
+#define HOST_TO_LE64(x) (x)
+#endif
+
+
+// Free space as seen by the producer, needed is the number of bytes the caller wants
+static inline size_t producerFree(cBuffer_t *inst, size_t needed)
+{
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        // Work from the cached copy of tail, the shared line is only loaded
+        // when the copy shows less space than needed
+        size_t num_free = cBufferCapacity(inst) - cBufferUsedBytes(inst, inst->head, inst->cached_tail);
+        if (num_free >= needed) {
+            return num_free;
+        }
+
+        inst->cached_tail = cBufferLoadTail(inst);
+        return cBufferCapacity(inst) - cBufferUsedBytes(inst, inst->head, inst->cached_tail);
+    }
+#else
+    (void)needed;
+#endif
+
+    return cBufferCapacity(inst) - cBufferUsedBytes(inst, inst->head, cBufferLoadTail(inst));
+}
+
+// Stored bytes as seen by the consumer, needed is the number of bytes the caller wants
+static inline size_t consumerUsed(cBuffer_t *inst, size_t needed)
+{
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        size_t num_used = cBufferUsedBytes(inst, inst->cached_head, inst->tail);
+        if (num_used >= needed) {
+            return num_used;
+        }
+
+        inst->cached_head = cBufferLoadHead(inst);
+        return cBufferUsedBytes(inst, inst->cached_head, inst->tail);
+    }
+#else
+    (void)needed;
+#endif
+
+    return cBufferUsedBytes(inst, cBufferLoadHead(inst), inst->tail);
+}
+
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+// Must be used when an index is moved outside of the normal producer and consumer flow,
+// a cached copy may lag behind the real index but never be ahead of it
+#define SYNC_CACHED_TAIL(inst) ((inst)->cached_tail = (inst)->tail)
+#define SYNC_CACHED_INDEXES(inst) ((inst)->cached_tail = (inst)->tail, (inst)->cached_head = (inst)->head)
+#else
+#define SYNC_CACHED_TAIL(inst)
+#define SYNC_CACHED_INDEXES(inst)
+#endif
+
+// Empty buffers restart at the headroom so that prepends land right in front of the data
+static inline void resetIndexes(cBuffer_t *inst)
+{
+    inst->head = (cBufferIndex_t)inst->headroom;
+    inst->tail = (cBufferIndex_t)inst->headroom;
+}
+
+// An empty buffer with headroom starts over at it, so the next prepends don't wrap
+static inline void restartAtHeadroom(cBuffer_t *inst)
+{
+    if (inst->headroom > 0 && !(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        resetIndexes(inst);
+    }
+}
+
+#ifdef C_BUFFER_DMA
+// The hardware is the only producer in DMA mode
+#define CPU_WRITE_ALLOWED(inst) (!((inst)->mode & C_BUFFER_MODE_DMA))
+#else
+#define CPU_WRITE_ALLOWED(inst) 1
+#endif
+
+#ifdef C_BUFFER_MPSC
+// Called while an MPSC producer waits for earlier reservations to be published
+#ifndef C_BUFFER_MPSC_RELAX
+#define C_BUFFER_MPSC_RELAX()
+#endif
+
+// The reservation cursor follows head whenever head is moved by anyone but a producer
+#define SYNC_RESERVE(inst) ((inst)->reserve = (inst)->head)
+#else
+#define SYNC_RESERVE(inst)
+#endif
+
+// The index that limits the free space, in MPSC mode this includes unpublished reservations
+static inline cBufferIndex_t loadWriteIndex(const cBuffer_t *inst)
+{
+#ifdef C_BUFFER_MPSC
+    if (inst->mode & C_BUFFER_MODE_MPSC) {
+        return __atomic_load_n(&inst->reserve, __ATOMIC_ACQUIRE);
+    }
+#endif
+
+    return cBufferLoadHead(inst);
+}
+
+#ifdef NO_MEMCPY
+// The copy moves native words, may_alias lets them access any byte array
+#if defined(__GNUC__) || defined(__clang__)
+typedef uintptr_t __attribute__((__may_alias__)) copyWord_t;
+#else
+typedef uintptr_t copyWord_t;
+#endif
+
+// Targets that load unaligned words in hardware can copy words between any two pointers
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__ARM_FEATURE_UNALIGNED) || defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+#define COPY_UNALIGNED_SRC
+typedef uintptr_t __attribute__((__may_alias__, __aligned__(1))) copyWordUnaligned_t;
+#endif
+
+#define COPY_WORD_SIZE sizeof(copyWord_t)
+#define COPY_WORD_MASK (COPY_WORD_SIZE - 1)
+
+void cBufferCopyWords(uint8_t *dst, const uint8_t *src, size_t size)
 {
-    return (value + modulus - (decrement % modulus)) % modulus;
+    // Short copies are not worth the alignment work
+    if (size >= 4 * COPY_WORD_SIZE) {
+        // Align the destination, the source follows if both have the same offset
+        while ((uintptr_t)dst & COPY_WORD_MASK) {
+            *dst++ = *src++;
+            size--;
+        }
+
+        copyWord_t *dst_word = (copyWord_t *)dst;
+
+        if (((uintptr_t)src & COPY_WORD_MASK) == 0) {
+            const copyWord_t *src_word = (const copyWord_t *)src;
+
+            // Load four words before storing them, GCC turns this into LDM/STM on Cortex-M
+            while (size >= 4 * COPY_WORD_SIZE) {
+                copyWord_t w0 = src_word[0];
+                copyWord_t w1 = src_word[1];
+                copyWord_t w2 = src_word[2];
+                copyWord_t w3 = src_word[3];
+                dst_word[0] = w0;
+                dst_word[1] = w1;
+                dst_word[2] = w2;
+                dst_word[3] = w3;
+                src_word += 4;
+                dst_word += 4;
+                size     -= 4 * COPY_WORD_SIZE;
+            }
+
+            while (size >= COPY_WORD_SIZE) {
+                *dst_word++ = *src_word++;
+                size -= COPY_WORD_SIZE;
+            }
+
+            src = (const uint8_t *)src_word;
+        }
+#ifdef COPY_UNALIGNED_SRC
+        else {
+            const copyWordUnaligned_t *src_word = (const copyWordUnaligned_t *)src;
+
+            while (size >= COPY_WORD_SIZE) {
+                *dst_word++ = *src_word++;
+                size -= COPY_WORD_SIZE;
+            }
+
+            src = (const uint8_t *)src_word;
+        }
+#endif
+
+        dst = (uint8_t *)dst_word;
+    }
+
+    // The rest, and all of it when the pointers can't be aligned together
+    while (size > 0) {
+        *dst++ = *src++;
+        size--;
+    }
+}
+#endif
+
+// Copy data into the buffer starting at an array position, handles the wrap
+static void copyToBuffer(cBuffer_t *inst, size_t pos, const uint8_t *data, size_t data_size)
+{
+    size_t first = data_size;
+
+    if (pos + data_size > cBufferLinearSize(inst)) {
+        first = inst->size - pos;
+    }
+
+    cBufferCopyBytes(inst->data + pos, data, first);
+    cBufferCopyBytes(inst->data, data + first, data_size - first);
+}
+
+#ifdef C_BUFFER_MPSC
+// Claim space for one of several producers by moving the reservation cursor with a CAS
+static int32_t mpscReserve(cBuffer_t *inst, size_t data_size, cBufferIndex_t *index)
+{
+    *index = __atomic_load_n(&inst->reserve, __ATOMIC_RELAXED);
+
+    do {
+        if (cBufferCapacity(inst) - cBufferUsedBytes(inst, *index, cBufferLoadTail(inst)) < data_size) {
+            STATS_INSUFFICIENT(inst);
+            return C_BUFFER_INSUFFICIENT;
+        }
+    } while (!__atomic_compare_exchange_n(&inst->reserve, index, *index + (cBufferIndex_t)data_size, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return C_BUFFER_SUCCESS;
+}
+
+// Move head past a reservation once all earlier reservations are published
+static void mpscPublish(cBuffer_t *inst, cBufferIndex_t index, size_t data_size)
+{
+    // Wait for the producers that reserved before this one
+    while (__atomic_load_n(&inst->head, __ATOMIC_ACQUIRE) != index) {
+        C_BUFFER_MPSC_RELAX();
+    }
+
+    // Only one producer at a time gets here, so the stats need no atomics
+    STATS_WRITE(inst, data_size, cBufferIndexToPos(inst, index) + data_size >= inst->size);
+    __atomic_store_n(&inst->head, index + (cBufferIndex_t)data_size, __ATOMIC_RELEASE);
+}
+
+// Append from one of several producers. The data is copied without any lock
+// between the reservation and the publish, so the consumer only ever sees
+// completed writes and they appear in reservation order.
+static cBufferSsize_t mpscAppend(cBuffer_t *inst, const uint8_t *data, size_t data_size)
+{
+    cBufferIndex_t index;
+
+    int32_t res = mpscReserve(inst, data_size, &index);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    copyToBuffer(inst, cBufferIndexToPos(inst, index), data, data_size);
+    mpscPublish(inst, index, data_size);
+
+    return data_size;
+}
+#endif
+
+// Copy a list of pieces back to back from an array position, across the wrap
+static void copyPiecesToBuffer(cBuffer_t *inst, size_t pos, const cBufferRegion_t *pieces, size_t num_pieces)
+{
+    for (size_t ind = 0; ind < num_pieces; ind++) {
+        copyToBuffer(inst, pos, pieces[ind].data, pieces[ind].size);
+
+        pos += pieces[ind].size;
+        if (pos >= inst->size) {
+            pos -= inst->size;
+        }
+    }
 }
 
 int32_t cBufferInit(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
@@ -48,546 +335,1397 @@ int32_t cBufferInit(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    inst->data = buffer;
-    inst->size = buffer_size;
-    inst->head = 0;
-    inst->tail = 0;
+    // The indexes and the number of bytes in the buffer must fit in the return values
+    if (buffer_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    inst->data = buffer;
+    inst->size = buffer_size;
+    inst->head = 0;
+    inst->tail = 0;
+    SYNC_RESERVE(inst);
+    inst->mode = 0;
+    inst->headroom = 0;
+    SYNC_CACHED_INDEXES(inst);
+    STATS_CLEAR(inst);
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferInitPow2(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
+    if (inst == NULL || buffer == NULL || buffer_size == 0) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    // The free running counters must wrap on a multiple of the size, and the
+    // number of bytes in the buffer must fit in the return values
+    if ((buffer_size & (buffer_size - 1)) != 0 || buffer_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    inst->data = buffer;
+    inst->size = buffer_size;
+    inst->head = 0;
+    inst->tail = 0;
+    SYNC_RESERVE(inst);
+    inst->mode = C_BUFFER_MODE_POW2;
+    inst->headroom = 0;
+    SYNC_CACHED_INDEXES(inst);
+    STATS_CLEAR(inst);
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferInitSpsc(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
+    int32_t res = cBufferInitPow2(inst, buffer, buffer_size);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    inst->mode |= C_BUFFER_MODE_SPSC;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferInitAligned(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
+    // The hardware ring wrap only works on an array aligned to its own size
+    if (buffer != NULL && buffer_size != 0 && ((uintptr_t)buffer & (buffer_size - 1)) != 0) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    return cBufferInitPow2(inst, buffer, buffer_size);
+}
+
+int32_t cBufferInitWithHeadroom(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size, size_t headroom) {
+    int32_t res = cBufferInit(inst, buffer, buffer_size);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    return cBufferReserveHeadroom(inst, headroom);
+}
+
+int32_t cBufferReserveHeadroom(cBuffer_t *inst, size_t headroom) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    // Both indexes are moved, which only one owner may do
+    if (inst->mode & (C_BUFFER_MODE_SPSC | C_BUFFER_MODE_DMA)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    // At least one byte must be left for data
+    if (inst->head != inst->tail || headroom >= cBufferCapacity(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    inst->headroom = headroom;
+    resetIndexes(inst);
+
+    return C_BUFFER_SUCCESS;
+}
+
+#ifdef C_BUFFER_MPSC
+int32_t cBufferInitMpsc(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size) {
+    int32_t res = cBufferInitSpsc(inst, buffer, buffer_size);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    inst->mode |= C_BUFFER_MODE_MPSC;
+
+    return C_BUFFER_SUCCESS;
+}
+#endif
+
+int32_t cBufferFull(cBuffer_t *inst)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return cBufferUsedBytes(inst, loadWriteIndex(inst), cBufferLoadTail(inst)) == cBufferCapacity(inst);
+}
+
+int32_t cBufferEmpty(cBuffer_t *inst)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return cBufferLoadHead(inst) == cBufferLoadTail(inst);
+}
+
+cBufferSsize_t cBufferAvailableForRead(cBuffer_t* inst)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return cBufferUsedBytes(inst, cBufferLoadHead(inst), cBufferLoadTail(inst));
+}
+
+cBufferSsize_t cBufferAvailableForWrite(cBuffer_t* inst)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return cBufferCapacity(inst) - cBufferUsedBytes(inst, loadWriteIndex(inst), cBufferLoadTail(inst));
+}
+
+cBufferSsize_t cBufferPrepend(cBuffer_t *inst, uint8_t *data, size_t data_size) {
+    if (inst == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    if (data_size == 0) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    // This cast is safe as the inst null check is allready done
+    if ((size_t)cBufferAvailableForWrite(inst) < data_size) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // An empty buffer restarts at the headroom, SPSC buffers can't be reset
+    // as head is owned by the producer.
+    if (!(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        resetIndexes(inst);
+    }
+
+    // The new tail is where the copy starts, it wraps the same way as an append
+    cBufferIndex_t new_tail = cBufferIndexDec(inst, inst->tail, data_size);
+    copyToBuffer(inst, cBufferIndexToPos(inst, new_tail), data, data_size);
+
+    // Update the tail
+    STATS_WRITE(inst, data_size, data_size > cBufferIndexToPos(inst, inst->tail));
+    cBufferStoreTail(inst, new_tail);
+    SYNC_CACHED_TAIL(inst);
+
+    return data_size;
+}
+
+// Append a word that is already in its wire byte order
+static inline int32_t appendWord(cBuffer_t *inst, const uint8_t *word, size_t width)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+#ifdef C_BUFFER_MPSC
+    if (inst->mode & C_BUFFER_MODE_MPSC) {
+        return mpscAppend(inst, word, width);
+    }
+#endif
+
+    if (producerFree(inst, width) < width) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    size_t head = cBufferIndexToPos(inst, inst->head);
+
+    if (head + width <= cBufferLinearSize(inst)) {
+        // The width is constant so this is a single unaligned store
+        cBufferCopyBytes(inst->data + head, word, width);
+    } else {
+        // Split the word at the wrap
+        for (size_t ind = 0; ind < width; ind++) {
+            inst->data[cBufferIndexToPos(inst, cBufferIndexInc(inst, inst->head, ind))] = word[ind];
+        }
+    }
+
+    STATS_WRITE(inst, width, head + width >= inst->size);
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, width));
+
+    return width;
+}
+
+// Prepend a word that is already in its wire byte order
+static inline int32_t prependWord(cBuffer_t *inst, const uint8_t *word, size_t width)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    // Same check as cBufferPrepend, unpublished MPSC reservations count as used
+    if ((size_t)cBufferAvailableForWrite(inst) < width) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Reset empty buffers the same way as cBufferPrepend
+    if (!(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        resetIndexes(inst);
+    }
+
+    cBufferIndex_t new_tail = cBufferIndexDec(inst, inst->tail, width);
+    size_t   tail     = cBufferIndexToPos(inst, new_tail);
+
+    if (tail + width <= cBufferLinearSize(inst)) {
+        cBufferCopyBytes(inst->data + tail, word, width);
+    } else {
+        for (size_t ind = 0; ind < width; ind++) {
+            inst->data[cBufferIndexToPos(inst, cBufferIndexInc(inst, new_tail, ind))] = word[ind];
+        }
+    }
+
+    STATS_WRITE(inst, width, width > cBufferIndexToPos(inst, inst->tail));
+    cBufferStoreTail(inst, new_tail);
+    SYNC_CACHED_TAIL(inst);
+
+    return width;
+}
+
+// Read a word in its wire byte order
+static inline int32_t readWord(cBuffer_t *inst, uint8_t *word, size_t width)
+{
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (consumerUsed(inst, width) < width) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t tail = cBufferIndexToPos(inst, inst->tail);
+
+    if (tail + width <= cBufferLinearSize(inst)) {
+        cBufferCopyBytes(word, inst->data + tail, width);
+    } else {
+        for (size_t ind = 0; ind < width; ind++) {
+            word[ind] = inst->data[cBufferIndexToPos(inst, cBufferIndexInc(inst, inst->tail, ind))];
+        }
+    }
+
+    STATS_READ(inst, width);
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, width));
+
+    return width;
+}
+
+int32_t cBufferPrependUint16(cBuffer_t *inst, uint16_t data) {
+    uint16_t raw = HOST_TO_BE16(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependUint32(cBuffer_t *inst, uint32_t data) {
+    uint32_t raw = HOST_TO_BE32(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependUint64(cBuffer_t *inst, uint64_t data) {
+    uint64_t raw = HOST_TO_BE64(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependUint16Le(cBuffer_t *inst, uint16_t data) {
+    uint16_t raw = HOST_TO_LE16(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependUint32Le(cBuffer_t *inst, uint32_t data) {
+    uint32_t raw = HOST_TO_LE32(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependUint64Le(cBuffer_t *inst, uint64_t data) {
+    uint64_t raw = HOST_TO_LE64(data);
+    return prependWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferPrependByte(cBuffer_t *inst, uint8_t data) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    // This cast is safe as the inst null check is allready done
+    if ((size_t)cBufferAvailableForWrite(inst) < 1) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Look for the special case were the buffer is empty
+    if (!(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        // For good reasons we want to reset the buffer when this happens.
+        resetIndexes(inst);
+    }
+
+    // Step back, this wraps to the end of the array if tail is at zero
+    cBufferIndex_t new_tail = cBufferIndexDec(inst, inst->tail, 1);
+    inst->data[cBufferIndexToPos(inst, new_tail)] = data;
+    STATS_WRITE(inst, 1, cBufferIndexToPos(inst, inst->tail) == 0);
+    cBufferStoreTail(inst, new_tail);
+    SYNC_CACHED_TAIL(inst);
+
+    return 1;
+}
+
+cBufferSsize_t cBufferAppend(cBuffer_t *inst, uint8_t *data, size_t data_size) {
+    if (inst == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    if (data_size == 0) {
+        return C_BUFFER_SUCCESS;
+    }
+
+#ifdef C_BUFFER_MPSC
+    if (inst->mode & C_BUFFER_MODE_MPSC) {
+        return mpscAppend(inst, data, data_size);
+    }
+#endif
+
+    if (producerFree(inst, data_size) < data_size) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    restartAtHeadroom(inst);
+
+    size_t head = cBufferIndexToPos(inst, inst->head);
+    copyToBuffer(inst, head, data, data_size);
+
+    STATS_WRITE(inst, data_size, head + data_size >= inst->size);
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, data_size));
+
+    return data_size;
+}
+
+cBufferSsize_t cBufferAppendOverwrite(cBuffer_t *inst, uint8_t *data, size_t data_size, size_t *dropped) {
+    if (inst == NULL || data == NULL || dropped == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    // The tail belongs to the consumer in the lock free modes
+    if (inst->mode & (C_BUFFER_MODE_SPSC | C_BUFFER_MODE_DMA)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    *dropped = 0;
+
+    if (data_size == 0) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    if (data_size > cBufferCapacity(inst)) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Move the tail past the oldest bytes first, then it is a plain append
+    size_t num_free = cBufferCapacity(inst) - cBufferUsedBytes(inst, inst->head, inst->tail);
+    if (num_free < data_size) {
+        *dropped = data_size - num_free;
+        STATS_READ(inst, *dropped);
+        inst->tail = cBufferIndexInc(inst, inst->tail, *dropped);
+    }
+
+    restartAtHeadroom(inst);
+
+    size_t head = cBufferIndexToPos(inst, inst->head);
+    copyToBuffer(inst, head, data, data_size);
+
+    STATS_WRITE(inst, data_size, head + data_size >= inst->size);
+    inst->head = cBufferIndexInc(inst, inst->head, data_size);
+
+    return data_size;
+}
+
+// Sum the sizes of a piece list, returns cBufferErr_t or the total
+static cBufferSsize_t piecesSize(const cBufferRegion_t *pieces, size_t num_pieces)
+{
+    size_t total = 0;
+
+    if (pieces == NULL && num_pieces > 0) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    for (size_t ind = 0; ind < num_pieces; ind++) {
+        if (pieces[ind].data == NULL && pieces[ind].size > 0) {
+            return C_BUFFER_NULL_ERROR;
+        }
+
+        if (pieces[ind].size > C_BUFFER_MAX_SIZE - total) {
+            return C_BUFFER_MISMATCH;
+        }
+        total += pieces[ind].size;
+    }
+
+    return total;
+}
+
+cBufferSsize_t cBufferAppendv(cBuffer_t *inst, const cBufferRegion_t *pieces, size_t num_pieces) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    cBufferSsize_t res = piecesSize(pieces, num_pieces);
+    if (res <= C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    size_t data_size = res;
+
+#ifdef C_BUFFER_MPSC
+    if (inst->mode & C_BUFFER_MODE_MPSC) {
+        cBufferIndex_t index;
+        res = mpscReserve(inst, data_size, &index);
+        if (res != C_BUFFER_SUCCESS) {
+            return res;
+        }
+
+        copyPiecesToBuffer(inst, cBufferIndexToPos(inst, index), pieces, num_pieces);
+        mpscPublish(inst, index, data_size);
+
+        return data_size;
+    }
+#endif
+
+    // One space check for all pieces, nothing is written unless everything fits
+    if (producerFree(inst, data_size) < data_size) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    restartAtHeadroom(inst);
+
+    size_t head = cBufferIndexToPos(inst, inst->head);
+    copyPiecesToBuffer(inst, head, pieces, num_pieces);
+
+    STATS_WRITE(inst, data_size, head + data_size >= inst->size);
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, data_size));
+
+    return data_size;
+}
+
+int32_t cBufferAppendByte(cBuffer_t *inst, uint8_t data) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+#ifdef C_BUFFER_MPSC
+    if (inst->mode & C_BUFFER_MODE_MPSC) {
+        return mpscAppend(inst, &data, 1);
+    }
+#endif
+
+    if (producerFree(inst, 1) < 1) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Look for the special case were the buffer is empty, SPSC buffers can't
+    // be reset as tail is owned by the consumer.
+    if (!(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        // For good reasons we want to reset the buffer when this happens.
+        resetIndexes(inst);
+    }
+
+    inst->data[cBufferIndexToPos(inst, inst->head)] = data;
+    STATS_WRITE(inst, 1, cBufferIndexToPos(inst, inst->head) == inst->size - 1);
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, 1));
+
+    return 1;
+}
+
+// Copy data out of the buffer starting at an array position, handles the wrap
+static void copyFromBuffer(const cBuffer_t *inst, size_t pos, uint8_t *data, size_t read_size)
+{
+    size_t first = read_size;
+
+    // Check if there is a wrap in the requested data
+    if (pos + read_size > cBufferLinearSize(inst)) {
+        first = inst->size - pos;
+    }
+
+    cBufferCopyBytes(data, inst->data + pos, first);
+    cBufferCopyBytes(data + first, inst->data, read_size - first);
+}
+
+int32_t cBufferAppendUint16(cBuffer_t *inst, uint16_t data) {
+    uint16_t raw = HOST_TO_BE16(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferAppendUint32(cBuffer_t *inst, uint32_t data) {
+    uint32_t raw = HOST_TO_BE32(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferAppendUint64(cBuffer_t *inst, uint64_t data) {
+    uint64_t raw = HOST_TO_BE64(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferAppendUint16Le(cBuffer_t *inst, uint16_t data) {
+    uint16_t raw = HOST_TO_LE16(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferAppendUint32Le(cBuffer_t *inst, uint32_t data) {
+    uint32_t raw = HOST_TO_LE32(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+int32_t cBufferAppendUint64Le(cBuffer_t *inst, uint64_t data) {
+    uint64_t raw = HOST_TO_LE64(data);
+    return appendWord(inst, (const uint8_t *)&raw, sizeof(raw));
+}
+
+cBufferSsize_t cBufferReadAll(cBuffer_t *inst, uint8_t *data, size_t max_read_size) {
+    if (inst == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    cBufferSsize_t num_bytes_in_buffer = cBufferAvailableForRead(inst);
+
+    if (num_bytes_in_buffer < C_BUFFER_SUCCESS) {
+        return num_bytes_in_buffer;
+    }
+
+    if ((size_t)num_bytes_in_buffer > max_read_size) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    copyFromBuffer(inst, cBufferIndexToPos(inst, inst->tail), data, num_bytes_in_buffer);
+    STATS_READ(inst, num_bytes_in_buffer);
+
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        // Only consume what was read, the producer may have appended more
+        cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, num_bytes_in_buffer));
+    } else {
+        // Reset the buffer pointers
+        resetIndexes(inst);
+    }
+
+    return num_bytes_in_buffer;
+}
+
+uint8_t cBufferReadByte(cBuffer_t *inst) {
+    if (inst == NULL) {
+        return 0;
+    }
+
+    // Protect from empty buffers
+    if (consumerUsed(inst, 1) == 0) {
+        LOG_DEBUG("Reading from empty buffer!\n");
+        return 0;
+    }
+
+    // Get the next data
+    uint8_t data = inst->data[cBufferIndexToPos(inst, inst->tail)];
+
+    STATS_READ(inst, 1);
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, 1));
+
+    return data;
+}
+
+cBufferSsize_t cBufferReadBytes(cBuffer_t *inst, uint8_t *data, size_t read_size) {
+    cBufferSsize_t res = cBufferPeek(inst, 0, data, read_size);
+
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    STATS_READ(inst, read_size);
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, read_size));
+
+    return read_size;
+}
+
+cBufferSsize_t cBufferReadv(cBuffer_t *inst, const cBufferRegion_t *pieces, size_t num_pieces) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    cBufferSsize_t res = piecesSize(pieces, num_pieces);
+    if (res <= C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    size_t read_size = res;
+
+    // Nothing is consumed unless every piece can be filled
+    if (read_size > consumerUsed(inst, read_size)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t pos = cBufferIndexToPos(inst, inst->tail);
+    for (size_t ind = 0; ind < num_pieces; ind++) {
+        copyFromBuffer(inst, pos, pieces[ind].data, pieces[ind].size);
+
+        pos += pieces[ind].size;
+        if (pos >= inst->size) {
+            pos -= inst->size;
+        }
+    }
+
+    STATS_READ(inst, read_size);
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, read_size));
+
+    return read_size;
+}
+
+int32_t cBufferReadUint16(cBuffer_t *inst, uint16_t *data) {
+    uint16_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_BE16(raw);
+    }
+
+    return res;
+}
+
+int32_t cBufferReadUint32(cBuffer_t *inst, uint32_t *data) {
+    uint32_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_BE32(raw);
+    }
+
+    return res;
+}
+
+int32_t cBufferReadUint64(cBuffer_t *inst, uint64_t *data) {
+    uint64_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_BE64(raw);
+    }
+
+    return res;
+}
+
+int32_t cBufferReadUint16Le(cBuffer_t *inst, uint16_t *data) {
+    uint16_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_LE16(raw);
+    }
+
+    return res;
+}
+
+int32_t cBufferReadUint32Le(cBuffer_t *inst, uint32_t *data) {
+    uint32_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_LE32(raw);
+    }
+
+    return res;
+}
+
+int32_t cBufferReadUint64Le(cBuffer_t *inst, uint64_t *data) {
+    uint64_t raw;
+    if (data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = readWord(inst, (uint8_t *)&raw, sizeof(raw));
+    if (res == sizeof(raw)) {
+        *data = HOST_TO_LE64(raw);
+    }
+
+    return res;
+}
+
+cBufferSsize_t cBufferPeek(cBuffer_t *inst, size_t offset, uint8_t *data, size_t read_size) {
+    if (inst == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    size_t num_bytes_in_buffer = consumerUsed(inst, offset + read_size);
+
+    if (offset > num_bytes_in_buffer || read_size > num_bytes_in_buffer - offset) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    copyFromBuffer(inst, cBufferIndexToPos(inst, cBufferIndexInc(inst, inst->tail, offset)), data, read_size);
+
+    return read_size;
+}
+
+uint8_t cBufferPeekByte(cBuffer_t *inst, size_t offset) {
+    if (inst == NULL) {
+        return 0;
+    }
+
+    // Protect from reading outside of the data
+    if (offset >= consumerUsed(inst, offset + 1)) {
+        LOG_DEBUG("Peeking outside of the buffer!\n");
+        return 0;
+    }
+
+    return inst->data[cBufferIndexToPos(inst, cBufferIndexInc(inst, inst->tail, offset))];
+}
+
+// Search the read regions for a byte, returns the offset or the total size if not found
+static size_t findInRegions(const cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], uint8_t byte, size_t offset)
+{
+    size_t region_start = 0;
+
+    for (int ind = 0; ind < C_BUFFER_NUM_REGIONS; ind++) {
+        size_t region_size = regions[ind].size;
+
+        if (offset < region_start + region_size) {
+            size_t start = offset - region_start;
+#ifdef NO_MEMCPY
+            for (size_t pos = start; pos < region_size; pos++) {
+                if (regions[ind].data[pos] == byte) {
+                    return region_start + pos;
+                }
+            }
+#else
+            // Let libc do the search, it is vectorized on most targets
+            uint8_t *match = memchr(regions[ind].data + start, byte, region_size - start);
+            if (match != NULL) {
+                return region_start + (size_t)(match - regions[ind].data);
+            }
+#endif
+            offset = region_start + region_size;
+        }
+
+        region_start += region_size;
+    }
+
+    return region_start;
+}
+
+// Compare the read regions with a pattern at an offset, the pattern must fit before the end
+static int matchInRegions(const cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], size_t offset, const uint8_t *pattern, size_t pattern_size)
+{
+    for (size_t ind = 0; ind < pattern_size; ind++) {
+        size_t pos = offset + ind;
+        uint8_t byte = pos < regions[0].size ? regions[0].data[pos] : regions[1].data[pos - regions[0].size];
+
+        if (byte != pattern[ind]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+cBufferSsize_t cBufferFind(cBuffer_t *inst, uint8_t byte, size_t start_offset) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+    int32_t res = cBufferGetReadRegions(inst, regions);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    size_t num_bytes = regions[0].size + regions[1].size;
+    size_t offset    = findInRegions(regions, byte, start_offset);
+
+    if (offset >= num_bytes) {
+        return C_BUFFER_NOT_FOUND;
+    }
+
+    return offset;
+}
+
+// Search the read regions for a pattern, returns the offset or the total size if not found
+static size_t findPatternInRegions(const cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], const uint8_t *pattern, size_t pattern_size, size_t offset)
+{
+    size_t num_bytes = regions[0].size + regions[1].size;
+
+    while (num_bytes >= pattern_size && offset <= num_bytes - pattern_size) {
+        // Jump to the next candidate and check the rest of the pattern
+        offset = findInRegions(regions, pattern[0], offset);
+        if (offset > num_bytes - pattern_size) {
+            break;
+        }
+
+        if (matchInRegions(regions, offset + 1, pattern + 1, pattern_size - 1)) {
+            return offset;
+        }
+
+        offset++;
+    }
+
+    return num_bytes;
+}
+
+cBufferSsize_t cBufferFindPattern(cBuffer_t *inst, uint8_t *pattern, size_t pattern_size, size_t start_offset) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+    if (pattern == NULL || pattern_size == 0) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = cBufferGetReadRegions(inst, regions);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    size_t num_bytes = regions[0].size + regions[1].size;
+    size_t offset    = findPatternInRegions(regions, pattern, pattern_size, start_offset);
+
+    if (offset >= num_bytes) {
+        return C_BUFFER_NOT_FOUND;
+    }
+
+    return offset;
+}
+
+cBufferSsize_t cBufferScan(cBuffer_t *inst, uint8_t *pattern, size_t pattern_size, size_t *scan_offset) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+    if (pattern == NULL || pattern_size == 0 || scan_offset == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t res = cBufferGetReadRegions(inst, regions);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    size_t num_bytes = regions[0].size + regions[1].size;
+    size_t offset    = findPatternInRegions(regions, pattern, pattern_size, *scan_offset);
+
+    if (offset >= num_bytes) {
+        // The end of the data may hold the start of the pattern, resume there next time
+        if (num_bytes >= pattern_size && num_bytes - pattern_size + 1 > *scan_offset) {
+            *scan_offset = num_bytes - pattern_size + 1;
+        }
+        return C_BUFFER_NOT_FOUND;
+    }
+
+    *scan_offset = offset;
+
+    return offset;
+}
+
+int32_t cBufferClear(cBuffer_t *inst) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+#ifdef C_BUFFER_DMA
+    // Head is owned by the hardware, discard everything it has written
+    if (inst->mode & C_BUFFER_MODE_DMA) {
+        cBufferStoreTail(inst, cBufferLoadHead(inst));
+        return C_BUFFER_SUCCESS;
+    }
+#endif
+
+    resetIndexes(inst);
+    SYNC_RESERVE(inst);
+    SYNC_CACHED_INDEXES(inst);
+
+    return C_BUFFER_SUCCESS;
+}
+
+#ifdef NO_MEMCPY
+// Move bytes in pieces no longer than the distance, so every piece is a plain copy
+static void moveBytes(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    if (dst < src) {
+        size_t distance = (size_t)(src - dst);
+
+        while (size > 0) {
+            size_t chunk = size < distance ? size : distance;
+            cBufferCopyBytes(dst, src, chunk);
+            dst  += chunk;
+            src  += chunk;
+            size -= chunk;
+        }
+    } else if (dst > src) {
+        size_t distance = (size_t)(dst - src);
+
+        // Start from the end when moving up, the source in front is not touched yet
+        while (size > 0) {
+            size_t chunk = size < distance ? size : distance;
+            size -= chunk;
+            cBufferCopyBytes(dst + size, src + size, chunk);
+        }
+    }
+}
+#else
+#define moveBytes(dst, src, size) memmove((dst), (src), (size))
+#endif
+
+#ifndef C_BUFFER_SWAP_CHUNK
+#define C_BUFFER_SWAP_CHUNK 64
+#endif
+
+// Swap two blocks of equal length that do not overlap
+static void swapBlocks(uint8_t *first, uint8_t *second, size_t len)
+{
+    uint8_t tmp[C_BUFFER_SWAP_CHUNK];
+
+    while (len > 0) {
+        size_t chunk = len < sizeof(tmp) ? len : sizeof(tmp);
+        cBufferCopyBytes(tmp, first, chunk);
+        cBufferCopyBytes(first, second, chunk);
+        cBufferCopyBytes(second, tmp, chunk);
+        first  += chunk;
+        second += chunk;
+        len    -= chunk;
+    }
+}
+
+// Rotate the array left by shift bytes with Gries-Mills block swaps
+static void rotateLeft(uint8_t *data, size_t size, size_t shift)
+{
+    size_t left  = shift;
+    size_t right = size - shift;
+
+    while (left != right) {
+        if (left < right) {
+            swapBlocks(data + shift - left, data + shift + right - left, left);
+            right -= left;
+        } else {
+            swapBlocks(data + shift - left, data + shift, right);
+            left -= right;
+        }
+    }
+
+    swapBlocks(data + shift - left, data + shift, left);
+}
+
+// Move wrapped data into contiguous memory, returns the new position of the tail
+static size_t removeWrap(cBuffer_t *inst, size_t tail, size_t num_of_bytes, uint8_t *scratch, size_t scratch_size)
+{
+    // The data is split in a first part from tail to the end of the array
+    // and a second part from the start of the array, with free space between.
+    size_t first_size  = inst->size - tail;
+    size_t second_size = num_of_bytes - first_size;
+    size_t free_size   = tail - second_size;
+
+    if (first_size <= free_size) {
+        // Move the second part up and place the first part in front of it
+        moveBytes(inst->data + first_size, inst->data, second_size);
+        cBufferCopyBytes(inst->data, inst->data + tail, first_size);
+        return 0;
+    }
+
+    if (second_size <= free_size) {
+        // Move the first part down and place the second part after it, at the end of the array
+        moveBytes(inst->data + tail - second_size, inst->data + tail, first_size);
+        cBufferCopyBytes(inst->data + inst->size - second_size, inst->data, second_size);
+        return tail - second_size;
+    }
+
+    // Park the smaller part in the scratch buffer while the larger part is moved
+    if (scratch != NULL && first_size <= second_size && first_size <= scratch_size) {
+        cBufferCopyBytes(scratch, inst->data + tail, first_size);
+        moveBytes(inst->data + first_size, inst->data, second_size);
+        cBufferCopyBytes(inst->data, scratch, first_size);
+        return 0;
+    }
+
+    if (scratch != NULL && second_size < first_size && second_size <= scratch_size) {
+        cBufferCopyBytes(scratch, inst->data, second_size);
+        moveBytes(inst->data + tail - second_size, inst->data + tail, first_size);
+        cBufferCopyBytes(inst->data + inst->size - second_size, scratch, second_size);
+        return tail - second_size;
+    }
+
+    // Not enough free space, rotate the whole array in place
+    rotateLeft(inst->data, inst->size, tail);
+
+    return 0;
+}
+
+static int32_t contiguate(cBuffer_t* inst, uint8_t *scratch, size_t scratch_size)
+{
+    // Data can't be moved under the hardware
+    if (!CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t num_of_bytes = cBufferUsedBytes(inst, inst->head, inst->tail);
+    size_t tail         = cBufferIndexToPos(inst, inst->tail);
+
+    // Check if there is a wrap in the buffer, or if it is empty
+    if (num_of_bytes == 0) {
+        // Make sure that tail points to the start of the data area
+        resetIndexes(inst);
+    } else if (tail + num_of_bytes > cBufferLinearSize(inst)) {
+        size_t new_tail = removeWrap(inst, tail, num_of_bytes, scratch, scratch_size);
+        STATS_CONTIGUATE(inst, num_of_bytes);
+
+        // Update the tail and head variables
+        inst->tail = new_tail;
+        inst->head = cBufferIndexInc(inst, new_tail, num_of_bytes);
+    } else {
+        return C_BUFFER_SUCCESS;
+    }
+
+    SYNC_RESERVE(inst);
+    SYNC_CACHED_INDEXES(inst);
 
     return C_BUFFER_SUCCESS;
 }
 
-int32_t cBufferFull(cBuffer_t *inst)
+int32_t cBufferContiguate(cBuffer_t* inst)
 {
     if (inst == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    return (MODULO_INC(inst->head, 1, inst->size) == inst->tail);
+    return contiguate(inst, NULL, 0);
 }
 
-int32_t cBufferEmpty(cBuffer_t *inst)
+int32_t cBufferContiguateScratch(cBuffer_t* inst, uint8_t *scratch, size_t scratch_size)
 {
-    if (inst == NULL) {
+    if (inst == NULL || scratch == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    return inst->head == inst->tail;
+    return contiguate(inst, scratch, scratch_size);
 }
 
-int32_t cBufferAvailableForRead(cBuffer_t* inst)
-{
+int32_t cBufferIsContigous(cBuffer_t* inst) {
     if (inst == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    if (inst->head < inst->tail) {
-        return ((inst->size - inst->tail) + inst->head);
-    } else {
-        return (inst->head - inst->tail);
+    // Check if there is a wrap in the buffer
+    if (cBufferIndexToPos(inst, inst->tail) + cBufferUsedBytes(inst, cBufferLoadHead(inst), inst->tail) > cBufferLinearSize(inst)) {
+        return C_BUFFER_WRAPED;
     }
 
     return C_BUFFER_SUCCESS;
 }
 
-int32_t cBufferAvailableForWrite(cBuffer_t* inst)
-{
+uint8_t *cBufferGetReadPointer(cBuffer_t* inst) {
     if (inst == NULL) {
-        return C_BUFFER_NULL_ERROR;
+        return NULL;
     }
 
-    if (inst->head < inst->tail) {
-        return inst->tail - inst->head - 1;
-    } else {
-        return inst->size - inst->head + inst->tail - 1;
-    }
-}
+    size_t tail = cBufferIndexToPos(inst, inst->tail);
 
-int32_t cBufferPrepend(cBuffer_t *inst, uint8_t *data, size_t data_size) {
-    if (inst == NULL || data == NULL) {
-        return C_BUFFER_NULL_ERROR;
+    // Protect from buffers with wraps
+    if (tail + cBufferUsedBytes(inst, cBufferLoadHead(inst), inst->tail) > cBufferLinearSize(inst)) {
+        return NULL;
     }
 
-    if (data_size == 0) {
-        return C_BUFFER_SUCCESS;
-    }
+    return &inst->data[tail];
+}
 
-    // This cast is safe as the inst null check is allready done
-    if ((size_t)cBufferAvailableForWrite(inst) < data_size) {
-        return C_BUFFER_INSUFFICIENT;
+int32_t cBufferGetReadRegions(cBuffer_t* inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]) {
+    if (inst == NULL || regions == NULL) {
+        return C_BUFFER_NULL_ERROR;
     }
 
-    // Look for the special case were the buffer is empty
-    if (inst->head == inst->tail) {
-        // For good reasons we want to reset the buffer when this happens.
-        inst->head = 0;
-        inst->tail = inst->size - data_size;
+    size_t num_bytes = cBufferUsedBytes(inst, cBufferLoadHead(inst), inst->tail);
+    size_t tail      = cBufferIndexToPos(inst, inst->tail);
 
-        // Copy the data
-#ifdef NO_MEMCPY
-        uint32_t data_ind = 0;
-        for (uint32_t ind = inst->tail; ind < inst->size; ind++) {
-            inst->data[ind] = data[data_ind];
-            data_ind++;
-        }
-#else
-        // Faster memcpy version
-        memcpy(inst->data + inst->tail, data, data_size);
-#endif
+    regions[0].data = NULL;
+    regions[0].size = 0;
+    regions[1].data = NULL;
+    regions[1].size = 0;
 
-        return data_size;
+    if (num_bytes == 0) {
+        return 0;
     }
 
-    // Check if we need to do a wrap copy
-    if (data_size > inst->tail) {
-        // First copy from 0 to current tail
-        size_t data_ind = data_size - inst->tail;
-
-#ifdef NO_MEMCPY
-        for (size_t ind = 0; ind < inst->tail; ind++)
-        {
-            inst->data[ind] = data[data_ind];
-            data_ind++;
-        }
-#else
-        // Faster memcpy version
-        memcpy(inst->data, data + data_ind, inst->tail);
-#endif
-
-        // Now copy up to the wrap
-        size_t new_tail = inst->size - (data_size - inst->tail);
-
-#ifdef NO_MEMCPY
-        size_t buffer_ind = new_tail;
-        for (size_t ind = 0; ind < data_size - inst->tail; ind++) {
-            inst->data[buffer_ind] = data[ind];
-            buffer_ind++;
-        }
-#else
-        // The faster memcpy verion of the code
-        memcpy(inst->data + new_tail, data, data_size - inst->tail);
-#endif
-
-        // Update the tail
-        inst->tail = new_tail;
-    } else {
-#ifdef NO_MEMCPY
-        size_t old_tail = inst->tail;
-        inst->tail = inst->tail - data_size;
+    regions[0].data = &inst->data[tail];
 
-        size_t data_ind = 0;
-        for (size_t ind = inst->tail; ind < old_tail; ind++) {
-            inst->data[ind] = data[data_ind];
-            data_ind++;
-        }
-#else
-        inst->tail = inst->tail - data_size;
-        // The faster memcpy version of the code
-        memcpy(inst->data + inst->tail, data, data_size);
-#endif
+    // Check if the data continues after the wrap
+    if (tail + num_bytes > cBufferLinearSize(inst)) {
+        regions[0].size = inst->size - tail;
+        regions[1].data = inst->data;
+        regions[1].size = num_bytes - regions[0].size;
+        return 2;
     }
 
-    return data_size;
-}
-
-int32_t cBufferPrependUint16(cBuffer_t *inst, uint16_t data) {
-    uint8_t tmp[2];
-    tmp[0] = (uint8_t)(data >> 8);
-    tmp[1] = (uint8_t)(data);
+    regions[0].size = num_bytes;
 
-    return cBufferPrepend(inst, tmp, sizeof(tmp));
+    return 1;
 }
 
-int32_t cBufferPrependUint32(cBuffer_t *inst, uint32_t data) {
-    uint8_t tmp[4];
-    tmp[0] = (uint8_t)(data >> 24);
-    tmp[1] = (uint8_t)(data >> 16);
-    tmp[2] = (uint8_t)(data >> 8);
-    tmp[3] = (uint8_t)(data);
+uint8_t *cBufferGetWritePointer(cBuffer_t* inst) {
+    if (inst == NULL) {
+        return NULL;
+    }
 
-    return cBufferPrepend(inst, tmp, sizeof(tmp));
+    return &inst->data[cBufferIndexToPos(inst, inst->head)];
 }
 
-int32_t cBufferPrependByte(cBuffer_t *inst, uint8_t data) {
-    if (inst == NULL) {
+int32_t cBufferReserveWrite(cBuffer_t* inst, size_t min_size, uint8_t **ptr, size_t *len) {
+    if (inst == NULL || ptr == NULL || len == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    // This cast is safe as the inst null check is allready done
-    if ((size_t)cBufferAvailableForWrite(inst) < 1) {
-        return C_BUFFER_INSUFFICIENT;
+    // Zero copy writes can not be ordered between several producers
+    if ((inst->mode & C_BUFFER_MODE_MPSC) || !CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
     }
 
-    // Look for the special case were the buffer is empty
-    if (inst->head == inst->tail) {
-        // For good reasons we want to reset the buffer when this happens.
-        inst->head = 0;
-        inst->tail = inst->size - 1;
-        // Copy the data
-        inst->data[inst->tail] = data;
-        return 1;
+    // An empty buffer can be reset to make the entire capacity contiguous
+    if (!(inst->mode & C_BUFFER_MODE_SPSC) && inst->head == inst->tail) {
+        resetIndexes(inst);
     }
 
-    // Check if we need to do a wrap copy
-    if (inst->tail == 0) {
-        inst->tail = inst->size - 1;
-        inst->data[inst->tail] = data;
-    } else {
-        inst->tail = inst->tail - 1;
-        inst->data[inst->tail] = data;
+    size_t num_free = producerFree(inst, min_size > 0 ? min_size : 1);
+    size_t head     = cBufferIndexToPos(inst, inst->head);
+
+    // The free space is cut at the end of the array
+    if (head + num_free > cBufferLinearSize(inst)) {
+        num_free = inst->size - head;
     }
 
-    return 1;
+    if (num_free < min_size || num_free == 0) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    *ptr = &inst->data[head];
+    *len = num_free;
+
+    return C_BUFFER_SUCCESS;
 }
 
-int32_t cBufferAppend(cBuffer_t *inst, uint8_t *data, size_t data_size) {
-    if (inst == NULL || data == NULL) {
+int32_t cBufferGetWriteRegions(cBuffer_t* inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]) {
+    if (inst == NULL || regions == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    if (data_size == 0) {
-        return C_BUFFER_SUCCESS;
-    }
-
-    // This cast is safe as the inst null check is allready done
-    if ((size_t)cBufferAvailableForWrite(inst) < data_size) {
-        return C_BUFFER_INSUFFICIENT;
+    if ((inst->mode & C_BUFFER_MODE_MPSC) || !CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
     }
 
-    // Check if we need to do a wrap copy
-    if (inst->head + data_size > inst->size) {
-        // Frist copy up to the wrap
-#ifdef NO_MEMCPY
-        size_t data_ind  = 0;
-        for (size_t ind = inst->head; ind < inst->size; ind++) {
-            inst->data[ind] = data[data_ind];
-            data_ind++;
-        }
-#else
-        memcpy(inst->data + inst->head, data, inst->size - inst->head);
-#endif
-
-#ifdef NO_MEMCPY
-        // Now copy from the wrap
-        size_t buffer_ind = 0;
-        for (size_t ind = data_ind; ind < data_size; ind++) {
-            inst->data[buffer_ind] = data[ind];
-            buffer_ind++;
-        }
-#else
-        memcpy(inst->data, data + (inst->size - inst->head), data_size - (inst->size - inst->head));
-#endif
+    restartAtHeadroom(inst);
 
-        inst->head = data_size - (inst->size - inst->head);
-    } else {
-        size_t new_head = inst->head + data_size;
-#ifdef NO_MEMCPY
-        size_t data_ind = 0;
-        for (size_t ind = inst->head; ind < new_head; ind++) {
-            inst->data[ind] = data[data_ind];
-            data_ind++;
-        }
-#else
-        memcpy(inst->data + inst->head, data, data_size);
-#endif
-        inst->head = new_head;
-    }
+    size_t num_free = cBufferCapacity(inst) - cBufferUsedBytes(inst, inst->head, cBufferLoadTail(inst));
+    size_t head     = cBufferIndexToPos(inst, inst->head);
 
-    return data_size;
-}
+    regions[0].data = NULL;
+    regions[0].size = 0;
+    regions[1].data = NULL;
+    regions[1].size = 0;
 
-int32_t cBufferAppendByte(cBuffer_t *inst, uint8_t data) {
-    if (inst == NULL) {
-        return C_BUFFER_NULL_ERROR;
+    if (num_free == 0) {
+        return 0;
     }
 
-    // This cast is safe as the inst null check is allready done
-    if ((size_t)cBufferAvailableForWrite(inst) < 1) {
-        return C_BUFFER_INSUFFICIENT;
-    }
+    regions[0].data = &inst->data[head];
 
-    // Look for the special case were the buffer is empty
-    if (inst->head == inst->tail) {
-        // For good reasons we want to reset the buffer when this happens.
-        inst->head = 0;
-        inst->tail = 0;
+    // Check if the free space continues after the wrap
+    if (head + num_free > cBufferLinearSize(inst)) {
+        regions[0].size = inst->size - head;
+        regions[1].data = inst->data;
+        regions[1].size = num_free - regions[0].size;
+        return 2;
     }
 
-    // Check if we need to do a wrap copy
-    inst->data[inst->head] = data;
-    inst->head = MODULO_INC(inst->head, 1, inst->size);
+    regions[0].size = num_free;
 
     return 1;
 }
 
-int32_t cBufferReadAll(cBuffer_t *inst, uint8_t *data, size_t max_read_size) {
-    if (inst == NULL || data == NULL) {
+cBufferSsize_t cBufferCommitWrite(cBuffer_t* inst, size_t num_bytes) {
+    if (inst == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    int32_t num_bytes_in_buffer = cBufferAvailableForRead(inst);
-
-    if (num_bytes_in_buffer < C_BUFFER_SUCCESS) {
-        return num_bytes_in_buffer;
+    if ((inst->mode & C_BUFFER_MODE_MPSC) || !CPU_WRITE_ALLOWED(inst)) {
+        return C_BUFFER_MISMATCH;
     }
 
-    if ((size_t)num_bytes_in_buffer > max_read_size) {
+    // Never let head pass tail
+    if (num_bytes > producerFree(inst, num_bytes)) {
+        STATS_INSUFFICIENT(inst);
         return C_BUFFER_INSUFFICIENT;
     }
 
-    // Check if there is a wrap in buffer
-    if (inst->head < inst->tail) {
-        // First read the data up to the wrap
-        size_t bytes_in_first = inst->size - inst->tail;
-#ifdef NO_MEMCPY
-        size_t data_ind = 0;
-        for (size_t ind = inst->tail; ind < inst->size; ind++) {
-            data[data_ind] = inst->data[ind];
-            data_ind++;
-        }
-#else
-        memcpy(data, inst->data + inst->tail, bytes_in_first);
-#endif
-
-       // Then read the remaining data after the wrap
-#ifdef NO_MEMCPY
-        for (size_t ind = 0; ind < num_bytes_in_buffer - bytes_in_first; ind++) {
-            data[data_ind] = inst->data[ind];
-            data_ind++;
-        }
-#else
-        memcpy(data + bytes_in_first, inst->data, num_bytes_in_buffer - bytes_in_first);
-#endif
-    } else {
-        // No data wrap, just read the data into the buffer
-#ifdef NO_MEMCPY
-        size_t buffer_ind = inst->tail;
-        for (size_t ind = 0; ind < num_bytes_in_buffer; ind++) {
-            data[ind] = inst->data[buffer_ind];
-            buffer_ind++;
-        }
-#else
-        // Faster memcpy version
-        memcpy(data, inst->data + inst->tail, num_bytes_in_buffer);
-#endif
-    }
+    STATS_WRITE(inst, num_bytes, cBufferIndexToPos(inst, inst->head) + num_bytes >= inst->size);
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, num_bytes));
 
-    // Reset the buffer pointers
-    inst->head = 0;
-    inst->tail = 0;
+    return num_bytes;
+}
 
-    return num_bytes_in_buffer;
+cBufferSsize_t cBufferEmptyWrite(cBuffer_t* inst, size_t num_bytes) {
+    return cBufferCommitWrite(inst, num_bytes);
 }
 
-uint8_t cBufferReadByte(cBuffer_t *inst) {
+cBufferSsize_t cBufferEmptyRead(cBuffer_t* inst, size_t num_bytes) {
     if (inst == NULL) {
-        return 0;
+        return C_BUFFER_NULL_ERROR;
     }
 
-    // Protect from empty buffers
-    if (cBufferEmpty(inst)) {
-        LOG_DEBUG("Reading from empty buffer!\n");
-        return 0;
+    if (num_bytes > consumerUsed(inst, num_bytes)) {
+        return C_BUFFER_MISMATCH;
     }
 
-    // Get the next data
-    uint8_t data = inst->data[inst->tail];
-
-    inst->tail = MODULO_INC(inst->tail, 1, inst->size);
+    STATS_READ(inst, num_bytes);
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, num_bytes));
 
-    return data;
+    return num_bytes;
 }
 
-int32_t cBufferReadBytes(cBuffer_t *inst, uint8_t *data, size_t read_size) {
-    if (inst == NULL || data == NULL) {
-        return C_BUFFER_NULL_ERROR;
-    }
-
-    int32_t num_bytes_in_buffer = cBufferAvailableForRead(inst);
+cBufferSsize_t cBufferTransfer(cBuffer_t *dst, cBuffer_t *src, size_t max_len) {
+    cBufferRegion_t to[C_BUFFER_NUM_REGIONS];
+    cBufferRegion_t from[C_BUFFER_NUM_REGIONS];
 
-    if (num_bytes_in_buffer < C_BUFFER_SUCCESS) {
-        return num_bytes_in_buffer;
+    if (dst == NULL || src == NULL) {
+        return C_BUFFER_NULL_ERROR;
     }
 
-    if (read_size > (size_t)num_bytes_in_buffer) {
+    if (dst == src) {
         return C_BUFFER_MISMATCH;
     }
 
-
-    // Check if there is a wrap in buffer
-    if (inst->head < inst->tail) {
-        size_t bytes_in_first = inst->size - inst->tail;
-        if (read_size <= bytes_in_first) {
-            // All requested data is in the first block.
-            // First read the data up to the wrap
-#ifdef NO_MEMCPY
-            size_t data_ind = 0;
-            for (size_t ind = inst->tail; ind < inst->size; ind++) {
-                data[data_ind] = inst->data[ind];
-                data_ind++;
-            }
-#else
-            memcpy(data, inst->data + inst->tail, bytes_in_first);
-#endif
-        } else {
-            // Data is divided before and after wrap
-#ifdef NO_MEMCPY
-            size_t data_ind = 0;
-            for (size_t ind = inst->tail; ind < inst->size; ind++) {
-                data[data_ind] = inst->data[ind];
-                data_ind++;
-            }
-#else
-            memcpy(data, inst->data + inst->tail, bytes_in_first);
-#endif
-
-        // Then read the remaining data after the wrap
-#ifdef NO_MEMCPY
-            for (size_t ind = 0; ind < read_size - bytes_in_first; ind++) {
-                data[data_ind] = inst->data[ind];
-                data_ind++;
-            }
-#else
-            memcpy(data + bytes_in_first, inst->data, read_size - bytes_in_first);
-#endif
-        }
-    } else {
-        // No data wrap, just read the data into the buffer
-#ifdef NO_MEMCPY
-        size_t buffer_ind = inst->tail;
-        for (size_t ind = 0; ind < read_size ; ind++) {
-            data[ind] = inst->data[buffer_ind];
-            buffer_ind++;
-        }
-#else
-        // Faster memcpy version
-        memcpy(data, inst->data + inst->tail, read_size);
-#endif
+    int32_t res = cBufferGetWriteRegions(dst, to);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
     }
 
-
-    inst->tail = MODULO_INC(inst->tail, read_size, inst->size);
-
-    return read_size;
-}
-
-int32_t cBufferClear(cBuffer_t *inst) {
-    if (inst == NULL) {
-        return C_BUFFER_NULL_ERROR;
+    res = cBufferGetReadRegions(src, from);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
     }
-    inst->head = 0;
-    inst->tail = 0;
-
-    return C_BUFFER_SUCCESS;
-}
 
-int32_t cBufferContiguate(cBuffer_t* inst)
-{
-    if (inst == NULL) {
-        return C_BUFFER_NULL_ERROR;
+    size_t num_bytes = from[0].size + from[1].size;
+    if (num_bytes > to[0].size + to[1].size) {
+        num_bytes = to[0].size + to[1].size;
+    }
+    if (num_bytes > max_len) {
+        num_bytes = max_len;
+    }
+    if (num_bytes > C_BUFFER_MAX_SIZE) {
+        num_bytes = C_BUFFER_MAX_SIZE;
     }
 
-    // Check if there is a wrap in the buffer, or if it is empty
-    if (cBufferEmpty(inst)) {
-        // Make sure that tail points to the start of the buffer
-        inst->head = 0;
-        inst->tail = 0;
-    } else if (inst->head < inst->tail && inst->head != 0) {
-        int32_t num_of_bytes = cBufferAvailableForRead(inst);
-
-        uint8_t* last_element  = &inst->data[inst->size - 1];
-        uint8_t* first_element = &inst->data[0];
-        uint8_t* tail_element  = &inst->data[inst->tail];
-
-        // Rotate the circular buffer to remove the wrap
-        uint8_t* next = tail_element;
-
-        while (first_element != next) {
-            uint8_t temp = *first_element;
-            *first_element = *next;
-            *next = temp;
-
-            first_element++;
-            if (next == last_element) {
-                next = tail_element;
-            } else {
-                next++;
-            }
+    // Walk both region pairs at once, every step ends at the end of a region
+    size_t to_ind = 0, to_pos = 0;
+    size_t from_ind = 0, from_pos = 0;
+    size_t remaining = num_bytes;
 
-            if (first_element == tail_element) {
-                tail_element = next;
-            }
+    while (remaining > 0) {
+        size_t chunk = remaining;
+        if (chunk > to[to_ind].size - to_pos) {
+            chunk = to[to_ind].size - to_pos;
+        }
+        if (chunk > from[from_ind].size - from_pos) {
+            chunk = from[from_ind].size - from_pos;
         }
 
-        // Update the tail and head variables
-        inst->tail = 0;
-        inst->head = num_of_bytes;
-    } else {
-        return C_BUFFER_SUCCESS;
-    }
+        cBufferCopyBytes(to[to_ind].data + to_pos, from[from_ind].data + from_pos, chunk);
 
-    return C_BUFFER_SUCCESS;
-}
+        remaining -= chunk;
+        to_pos    += chunk;
+        from_pos  += chunk;
 
-int32_t cBufferIsContigous(cBuffer_t* inst) {
-    if (inst == NULL) {
-        return C_BUFFER_NULL_ERROR;
+        if (to_pos == to[to_ind].size) {
+            to_ind++;
+            to_pos = 0;
+        }
+        if (from_pos == from[from_ind].size) {
+            from_ind++;
+            from_pos = 0;
+        }
     }
 
-    // Check if there is a wrap in the buffer
-    if (inst->head < inst->tail && inst->head != 0) {
-        return C_BUFFER_WRAPED;
-    }
+    // Publish in dst before the space is given back in src
+    cBufferCommitWrite(dst, num_bytes);
+    cBufferEmptyRead(src, num_bytes);
 
-    return C_BUFFER_SUCCESS;
+    return num_bytes;
 }
 
-uint8_t *cBufferGetReadPointer(cBuffer_t* inst) {
-    if (inst == NULL) {
-        return NULL;
-    }
-
-    // Protect from buffers with wraps
-    if (inst->head < inst->tail && inst->head != 0) {
-        return NULL;
+#ifdef C_BUFFER_STATS
+int32_t cBufferGetStats(cBuffer_t *inst, cBufferStats_t *stats) {
+    if (inst == NULL || stats == NULL) {
+        return C_BUFFER_NULL_ERROR;
     }
 
-    return &inst->data[inst->tail];
-}
-
-uint8_t *cBufferGetWritePointer(cBuffer_t* inst) {
-    if (inst == NULL) {
-        return NULL;
-    }
+    *stats = inst->stats;
 
-    return &inst->data[inst->head];
+    return C_BUFFER_SUCCESS;
 }
 
-int32_t cBufferEmptyWrite(cBuffer_t* inst, size_t num_bytes) {
+int32_t cBufferResetStats(cBuffer_t *inst) {
     if (inst == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    inst->head = MODULO_INC(inst->head, num_bytes, inst->size);
+    STATS_CLEAR(inst);
+    inst->stats.high_watermark = cBufferUsedBytes(inst, cBufferLoadHead(inst), cBufferLoadTail(inst));
 
-    return num_bytes;
+    return C_BUFFER_SUCCESS;
 }
+#endif
 
-int32_t cBufferEmptyRead(cBuffer_t* inst, size_t num_bytes) {
-    if (inst == NULL) {
+#ifdef C_BUFFER_DMA
+int32_t cBufferSetHeadCallback(cBuffer_t *inst, cBufferHeadCb_t head_cb, void *ctx) {
+    if (inst == NULL || head_cb == NULL) {
         return C_BUFFER_NULL_ERROR;
     }
 
-    int32_t num_bytes_in_buffer = cBufferAvailableForRead(inst);
-
-    if (num_bytes_in_buffer < C_BUFFER_SUCCESS) {
-        return num_bytes_in_buffer;
-    }
-
-    if (num_bytes > (size_t)num_bytes_in_buffer) {
+    // The hardware position is placed relative to tail with the mask
+    if (!(inst->mode & C_BUFFER_MODE_POW2) || (inst->mode & C_BUFFER_MODE_MPSC)) {
         return C_BUFFER_MISMATCH;
     }
 
-    inst->tail = MODULO_INC(inst->tail, num_bytes, inst->size);
+    inst->head_cb  = head_cb;
+    inst->head_ctx = ctx;
+    inst->mode    |= C_BUFFER_MODE_SPSC | C_BUFFER_MODE_DMA;
 
-    return num_bytes;
+    // Start consuming at the current hardware position
+    inst->tail = head_cb(ctx) & (inst->size - 1);
+    inst->head = inst->tail;
+    SYNC_RESERVE(inst);
+    SYNC_CACHED_INDEXES(inst);
+
+    return C_BUFFER_SUCCESS;
 }
+#endif
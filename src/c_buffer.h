@@ -40,6 +40,23 @@ extern "C" {
 // The available number of bytes in the C buffer will be one less than the size of the array
 #define C_BUFFER_ARRAY_OVERHEAD 1
 
+// Buffers initialized with cBufferInitPow2 can use the full size of the array
+#define C_BUFFER_POW2_ARRAY_OVERHEAD 0
+
+// Data in the buffer is at most split in two regions by the wrap
+#define C_BUFFER_NUM_REGIONS 2
+
+// Define C_BUFFER_LARGE for buffers above 2 GiB, indexes and returned byte counts become 64 bit
+#ifdef C_BUFFER_LARGE
+typedef uint64_t cBufferIndex_t;
+typedef int64_t  cBufferSsize_t;
+#define C_BUFFER_MAX_SIZE INT64_MAX
+#else
+typedef uint32_t cBufferIndex_t;
+typedef int32_t  cBufferSsize_t;
+#define C_BUFFER_MAX_SIZE INT32_MAX
+#endif
+
 /**
  * This module manages connections data streams.
  */
@@ -50,24 +67,203 @@ typedef enum {
     C_BUFFER_NULL_ERROR   = -301,
     C_BUFFER_INSUFFICIENT = -302,
     C_BUFFER_MISMATCH     = -303,
+    C_BUFFER_SYSTEM_ERROR = -304,
+    C_BUFFER_WOULD_BLOCK  = -305,
+    C_BUFFER_NOT_FOUND    = -306,
 } cBufferErr_t;
 
+typedef enum {
+    // Free running head and tail, all index math is done with a mask
+    C_BUFFER_MODE_POW2 = (1 << 0),
+    // Lock free single producer single consumer, each side only writes its own index
+    C_BUFFER_MODE_SPSC = (1 << 1),
+    // The array is mapped twice back to back, data is never split by the wrap
+    C_BUFFER_MODE_MIRRORED = (1 << 2),
+    // Several producers claim space with a CAS on the reservation cursor, implies SPSC
+    C_BUFFER_MODE_MPSC = (1 << 3),
+    // Head is derived from a callback that reads the hardware position, see cBufferSetHeadCallback
+    C_BUFFER_MODE_DMA = (1 << 4),
+} cBufferMode_t;
+
+#ifdef C_BUFFER_STATS
+// Usage history of a buffer, only available when built with C_BUFFER_STATS
+typedef struct {
+    size_t   high_watermark;     // Largest number of bytes stored at once
+    uint32_t insufficient_count; // Writes rejected with C_BUFFER_INSUFFICIENT
+    uint32_t wrap_count;         // Writes that crossed the end of the array
+    uint64_t contiguate_bytes;   // Bytes moved by cBufferContiguate
+    uint64_t bytes_in;           // Total bytes written
+    uint64_t bytes_out;          // Total bytes consumed
+} cBufferStats_t;
+#endif
+
+// Define C_BUFFER_CACHE_LINE_SIZE to place the producer and consumer indexes on
+// separate cache lines, each with a cached copy of the other side's index
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+#define C_BUFFER_CACHE_ALIGNED __attribute__((aligned(C_BUFFER_CACHE_LINE_SIZE)))
+#else
+#define C_BUFFER_CACHE_ALIGNED
+#endif
+
+#ifdef C_BUFFER_DMA
+// Returns the array position the hardware writes next, e.g. size - NDTR on STM32
+typedef uint32_t (*cBufferHeadCb_t)(void *ctx);
+#endif
+
 typedef struct {
     uint8_t *data;
     size_t  size;
-    uint32_t head;
-    uint32_t tail;
+    uint32_t mode;
+    // Empty buffers restart at this index, see cBufferReserveHeadroom
+    size_t  headroom;
+#ifdef C_BUFFER_DMA
+    cBufferHeadCb_t head_cb;
+    void *head_ctx;
+#endif
+    // Producer owned, in MPSC mode head only covers published data
+    C_BUFFER_CACHE_ALIGNED cBufferIndex_t head;
+#ifdef C_BUFFER_MPSC
+    cBufferIndex_t reserve;
+#endif
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+    cBufferIndex_t cached_tail;
+#endif
+    // Consumer owned
+    C_BUFFER_CACHE_ALIGNED cBufferIndex_t tail;
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+    cBufferIndex_t cached_head;
+#endif
+#ifdef C_BUFFER_STATS
+    C_BUFFER_CACHE_ALIGNED cBufferStats_t stats;
+#endif
 } cBuffer_t;
 
+// A contiguous span of the buffer array
+typedef struct {
+    uint8_t *data;
+    size_t   size;
+} cBufferRegion_t;
+
 /**
  * Initialize the buffer
  * Note: The available size in the buffer will be one less than input array
+ * Note: The size of the array must be no larger than C_BUFFER_MAX_SIZE
  * Input: Pointer to buffer instance
  * Input: Pointer to data array
  * Input: Size of the data array
  * Returns: cBufferErr_t
  */
 int32_t cBufferInit(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Initialize the buffer in power of two mode
+ * Head and tail are free running counters and all index math is done by masking,
+ * this avoids the division in every operation and the full array can be used.
+ * Note: The size of the array must be a power of two and no larger than C_BUFFER_MAX_SIZE
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data array
+ * Input: Size of the data array
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the size is not a power of two
+ */
+int32_t cBufferInitPow2(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Initialize the buffer as a lock free single producer single consumer queue
+ * The producer (Append, AppendByte, EmptyWrite, AvailableForWrite, Full) only writes
+ * head and the consumer (Read, EmptyRead, AvailableForRead, Empty) only writes tail.
+ * Indexes are published with release and loaded with acquire semantics, so no
+ * locking is needed between an ISR or thread on each side.
+ * Note: Prepend moves tail and is a consumer operation, the producer must not
+ * be writing while it is used. Clear and Contiguate are never safe concurrently.
+ * Note: With C_BUFFER_CACHE_LINE_SIZE defined each side checks space against a
+ * cached copy of the other index and only loads the shared one when the copy
+ * shows too little, the instance must then be allocated with that alignment.
+ * Note: The size of the array must be a power of two, see cBufferInitPow2
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data array
+ * Input: Size of the data array
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the size is not a power of two
+ */
+int32_t cBufferInitSpsc(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size);
+
+#ifdef C_BUFFER_MPSC
+/**
+ * Initialize the buffer as a lock free multi producer single consumer queue
+ * Any number of producers may use Append, AppendByte and the AppendUint functions
+ * at the same time. Each producer claims space with a CAS on the reservation
+ * cursor, copies its data and then waits for earlier producers to publish, so the
+ * consumer only sees complete writes in reservation order. The consumer side is
+ * the same as in SPSC mode.
+ * Note: A producer that is preempted between reserving and publishing stalls the
+ * later producers, so an ISR must not produce into a buffer that a thread it
+ * interrupts is producing into. Define C_BUFFER_MPSC_RELAX to add a pause or
+ * yield to the wait.
+ * Note: Only available when built with C_BUFFER_MPSC, it needs compare and swap
+ * support on the target, e.g. not ARMv6-M without libatomic
+ * Note: ReserveWrite, GetWriteRegions, CommitWrite and EmptyWrite return
+ * C_BUFFER_MISMATCH, and so do the record push and file descriptor reads
+ * Note: The size of the array must be a power of two, see cBufferInitPow2
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data array
+ * Input: Size of the data array
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the size is not a power of two
+ */
+int32_t cBufferInitMpsc(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size);
+#endif
+
+/**
+ * Initialize the buffer in power of two mode on an array aligned to its size
+ * DMA controllers with a hardware ring wrap, e.g. RP2040, only wrap on such arrays.
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data array
+ * Input: Size of the data array
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the size is not a power of two
+ *          or the array is not aligned to it
+ */
+int32_t cBufferInitAligned(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size);
+
+/**
+ * Initialize the buffer with room in front of the data for prepends
+ * Note: The available size in the buffer will be one less than input array
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data array
+ * Input: Size of the data array
+ * Input: Number of bytes kept in front of the data, see cBufferReserveHeadroom
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the headroom is not less than the capacity
+ */
+int32_t cBufferInitWithHeadroom(cBuffer_t *inst, uint8_t *buffer, size_t buffer_size, size_t headroom);
+
+/**
+ * Start the data of an empty buffer headroom bytes into the array
+ * Appended data then follows the headroom and headers prepended to it are
+ * written in front of it without wrapping, as long as they fit the headroom.
+ * The buffer restarts at the headroom every time it is reset while empty, and
+ * when data is appended to it while it is empty.
+ * Note: SPSC, MPSC and DMA buffers are never reset and return C_BUFFER_MISMATCH
+ * Input: Pointer to buffer instance
+ * Input: Number of bytes kept in front of the data, 0 to restore the default
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the buffer is not empty
+ *          or the headroom is not less than the capacity
+ */
+int32_t cBufferReserveHeadroom(cBuffer_t *inst, size_t headroom);
+
+#ifdef C_BUFFER_DMA
+/**
+ * Let hardware own the head of a power of two buffer, e.g. a circular DMA
+ * transfer into the data array. Head is derived by the callback every time it
+ * is needed and the CPU is the single consumer, as in SPSC mode. Reading starts
+ * at the current hardware position.
+ * Note: Writes, Prepend and Contiguate return C_BUFFER_MISMATCH and Clear
+ * discards the data the hardware has written. The hardware can't be stopped
+ * when the buffer is full, so at most size - 1 bytes can be told apart and more
+ * than that is lost without notice.
+ * Input: Pointer to buffer instance, initialized with cBufferInitPow2 or cBufferInitAligned
+ * Input: Callback that returns the hardware write position in the array
+ * Input: Context passed to the callback
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the buffer is not in power of two mode
+ */
+int32_t cBufferSetHeadCallback(cBuffer_t *inst, cBufferHeadCb_t head_cb, void *ctx);
+#endif
  
 /**
  * Check if the buffer is empty
@@ -88,14 +284,14 @@ int32_t cBufferFull(cBuffer_t *inst);
  * Input: Pointer to buffer instance
  * Returns: Number of bytes available or cBufferErr_t
  */
-int32_t cBufferAvailableForRead(cBuffer_t* inst);
+cBufferSsize_t cBufferAvailableForRead(cBuffer_t* inst);
 
 /**
  * Get number of bytes available for write
  * Input: Pointer to buffer instance
  * Returns: Number of bytes available or cBufferErr_t
  */
-int32_t cBufferAvailableForWrite(cBuffer_t* inst);
+cBufferSsize_t cBufferAvailableForWrite(cBuffer_t* inst);
 
 /**
  * Write the new data at the start of the buffer
@@ -104,7 +300,7 @@ int32_t cBufferAvailableForWrite(cBuffer_t* inst);
  * Input: Size of data to write
  * Returns: cBufferErr_t or num bytes written
  */
-int32_t cBufferPrepend(cBuffer_t *inst, uint8_t *data, size_t data_size);
+cBufferSsize_t cBufferPrepend(cBuffer_t *inst, uint8_t *data, size_t data_size);
 
 /**
  * Write a uint32 at the start of the buffer in big endian format
@@ -122,6 +318,38 @@ int32_t cBufferPrependUint32(cBuffer_t *inst, uint32_t data);
  */
 int32_t cBufferPrependUint16(cBuffer_t *inst, uint16_t data);
 
+/**
+ * Write a uint64 at the start of the buffer in big endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferPrependUint64(cBuffer_t *inst, uint64_t data);
+
+/**
+ * Write a uint16 at the start of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferPrependUint16Le(cBuffer_t *inst, uint16_t data);
+
+/**
+ * Write a uint32 at the start of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferPrependUint32Le(cBuffer_t *inst, uint32_t data);
+
+/**
+ * Write a uint64 at the start of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferPrependUint64Le(cBuffer_t *inst, uint64_t data);
+
 /**
  * Write a single byte at the start of the buffer
  * Input: Pointer to buffer instance
@@ -137,7 +365,28 @@ int32_t cBufferPrependByte(cBuffer_t *inst, uint8_t data);
  * Input: Size of data to write
  * Returns: cBufferErr_t or 1 if full
  */
-int32_t cBufferAppend(cBuffer_t *inst, uint8_t *data, size_t data_size);
+cBufferSsize_t cBufferAppend(cBuffer_t *inst, uint8_t *data, size_t data_size);
+
+/**
+ * Write the new data at the end of the buffer, dropping the oldest data to make room
+ * Note: Not available in SPSC, MPSC or DMA mode as the tail is moved by the writer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data to write
+ * Input: Size of data to write
+ * Input: Pointer to store the number of old bytes dropped
+ * Returns: cBufferErr_t or num bytes written, C_BUFFER_INSUFFICIENT if larger than the buffer
+ */
+cBufferSsize_t cBufferAppendOverwrite(cBuffer_t *inst, uint8_t *data, size_t data_size, size_t *dropped);
+
+/**
+ * Write a list of pieces at the end of the buffer as one contiguous append
+ * Note: Nothing is written unless all pieces fit
+ * Input: Pointer to buffer instance
+ * Input: Array of pieces to write, in order
+ * Input: Number of pieces in the array
+ * Returns: cBufferErr_t or total num bytes written, C_BUFFER_INSUFFICIENT if not all pieces fit
+ */
+cBufferSsize_t cBufferAppendv(cBuffer_t *inst, const cBufferRegion_t *pieces, size_t num_pieces);
 
 /**
  * Write the new data at the end of the buffer
@@ -147,6 +396,54 @@ int32_t cBufferAppend(cBuffer_t *inst, uint8_t *data, size_t data_size);
  */
 int32_t cBufferAppendByte(cBuffer_t *inst, uint8_t data);
 
+/**
+ * Write a uint16 at the end of the buffer in big endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint16(cBuffer_t *inst, uint16_t data);
+
+/**
+ * Write a uint32 at the end of the buffer in big endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint32(cBuffer_t *inst, uint32_t data);
+
+/**
+ * Write a uint64 at the end of the buffer in big endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint64(cBuffer_t *inst, uint64_t data);
+
+/**
+ * Write a uint16 at the end of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint16Le(cBuffer_t *inst, uint16_t data);
+
+/**
+ * Write a uint32 at the end of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint32Le(cBuffer_t *inst, uint32_t data);
+
+/**
+ * Write a uint64 at the end of the buffer in little endian format
+ * Input: Pointer to buffer instance
+ * Input: Data to write
+ * Returns: cBufferErr_t or num bytes written
+ */
+int32_t cBufferAppendUint64Le(cBuffer_t *inst, uint64_t data);
+
 /**
  * Read data from the buffer
  * Input: Pointer to buffer instance
@@ -154,7 +451,7 @@ int32_t cBufferAppendByte(cBuffer_t *inst, uint8_t data);
  * Input: Maximum amount amount of data that can be read
  * Returns: cBufferErr_t or num of bytes read
  */
-int32_t cBufferReadAll(cBuffer_t *inst, uint8_t *data, size_t max_read_size);
+cBufferSsize_t cBufferReadAll(cBuffer_t *inst, uint8_t *data, size_t max_read_size);
 
 /**
  * Read the next byte from the buffer
@@ -172,7 +469,118 @@ uint8_t cBufferReadByte(cBuffer_t *inst);
  * Input: Number of bytes to read
  * Returns: cBufferErr_t or num of bytes read
  */
-int32_t cBufferReadBytes(cBuffer_t *inst, uint8_t *data, size_t read_size);
+cBufferSsize_t cBufferReadBytes(cBuffer_t *inst, uint8_t *data, size_t read_size);
+
+/**
+ * Read data from the buffer into a list of pieces, filling each piece in order
+ * Note: Nothing is read unless all pieces can be filled
+ * Input: Pointer to buffer instance
+ * Input: Array of pieces to read into
+ * Input: Number of pieces in the array
+ * Returns: cBufferErr_t or total num bytes read, C_BUFFER_MISMATCH if not enough data
+ */
+cBufferSsize_t cBufferReadv(cBuffer_t *inst, const cBufferRegion_t *pieces, size_t num_pieces);
+
+/**
+ * Read a uint16 stored in big endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint16(cBuffer_t *inst, uint16_t *data);
+
+/**
+ * Read a uint32 stored in big endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint32(cBuffer_t *inst, uint32_t *data);
+
+/**
+ * Read a uint64 stored in big endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint64(cBuffer_t *inst, uint64_t *data);
+
+/**
+ * Read a uint16 stored in little endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint16Le(cBuffer_t *inst, uint16_t *data);
+
+/**
+ * Read a uint32 stored in little endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint32Le(cBuffer_t *inst, uint32_t *data);
+
+/**
+ * Read a uint64 stored in little endian format from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to store the value in
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is not enough data
+ */
+int32_t cBufferReadUint64Le(cBuffer_t *inst, uint64_t *data);
+
+/**
+ * Copy data from the buffer without consuming it
+ * Input: Pointer to buffer instance
+ * Input: Offset from the first byte in the buffer
+ * Input: Pointer to data to read into
+ * Input: Number of bytes to read
+ * Returns: cBufferErr_t or num of bytes read, C_BUFFER_MISMATCH if outside of the data
+ */
+cBufferSsize_t cBufferPeek(cBuffer_t *inst, size_t offset, uint8_t *data, size_t read_size);
+
+/**
+ * Get a byte from the buffer without consuming it
+ * Note: Peeking outside of the data will return 0
+ * Input: Pointer to buffer instance
+ * Input: Offset from the first byte in the buffer
+ * Returns: the byte at the offset
+ */
+uint8_t cBufferPeekByte(cBuffer_t *inst, size_t offset);
+
+/**
+ * Find the first occurrence of a byte in the buffer
+ * Input: Pointer to buffer instance
+ * Input: Byte to search for
+ * Input: Offset from the first byte in the buffer to start the search at
+ * Returns: cBufferErr_t or offset of the byte from the first byte in the buffer,
+ *          C_BUFFER_NOT_FOUND if it is not in the buffer
+ */
+cBufferSsize_t cBufferFind(cBuffer_t *inst, uint8_t byte, size_t start_offset);
+
+/**
+ * Find the first occurrence of a byte pattern in the buffer, such as "\r\n"
+ * Input: Pointer to buffer instance
+ * Input: Pointer to the pattern
+ * Input: Size of the pattern
+ * Input: Offset from the first byte in the buffer to start the search at
+ * Returns: cBufferErr_t or offset of the pattern from the first byte in the buffer,
+ *          C_BUFFER_NOT_FOUND if it is not in the buffer
+ */
+cBufferSsize_t cBufferFindPattern(cBuffer_t *inst, uint8_t *pattern, size_t pattern_size, size_t start_offset);
+
+/**
+ * Incrementally search a growing buffer for a byte pattern
+ * The scan offset remembers where the last search stopped so bytes are only
+ * searched once. Start it at 0 and reset it after data has been consumed.
+ * Input: Pointer to buffer instance
+ * Input: Pointer to the pattern
+ * Input: Size of the pattern
+ * Input: Pointer to the scan offset, updated by the search
+ * Returns: cBufferErr_t or offset of the pattern from the first byte in the buffer,
+ *          C_BUFFER_NOT_FOUND if it is not in the buffer yet
+ */
+cBufferSsize_t cBufferScan(cBuffer_t *inst, uint8_t *pattern, size_t pattern_size, size_t *scan_offset);
 
 /**
  * Clear a buffer, this resets the head and tail to first element of buffer
@@ -183,11 +591,24 @@ int32_t cBufferClear(cBuffer_t *inst);
 
 /**
  * Rotate the buffer to make sure the data is available in continous memory
+ * Note: Each byte is moved once if the smaller part of the data fits in the free
+ *       space, otherwise the array is rotated in place with block swaps
  * Input: Pointer to buffer instance
  * Returns: cBufferErr_t
  */
 int32_t cBufferContiguate(cBuffer_t* inst);
 
+/**
+ * Rotate the buffer to make sure the data is available in continous memory
+ * Uses the scratch buffer to hold the smaller part of the data when there is not
+ * enough free space in the buffer, falling back to cBufferContiguate if it is too small
+ * Input: Pointer to buffer instance
+ * Input: Pointer to scratch buffer
+ * Input: Size of the scratch buffer
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferContiguateScratch(cBuffer_t* inst, uint8_t *scratch, size_t scratch_size);
+
 /**
  * Check if the data is available in continous memory
  * Input: Pointer to buffer instance
@@ -202,22 +623,60 @@ int32_t cBufferIsContigous(cBuffer_t* inst);
  */
 uint8_t *cBufferGetReadPointer(cBuffer_t* inst);
 
+/**
+ * Get all readable data in place as up to two regions, the second region holds
+ * the data after the wrap. Nothing is consumed, use cBufferEmptyRead when the
+ * data has been processed.
+ * Input: Pointer to buffer instance
+ * Input: Array of C_BUFFER_NUM_REGIONS regions, unused regions are set to NULL and 0
+ * Returns: cBufferErr_t or number of regions holding data
+ */
+int32_t cBufferGetReadRegions(cBuffer_t* inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]);
+
 /**
  * Get pointer to the current next write element in the buffer
- * Note: There is no garantuee that the data is continous
+ * Note: There is no garantuee that the data is continous, see cBufferReserveWrite
  * Input: Pointer to buffer instance
  * Returns: Pointer to element
  */
 uint8_t *cBufferGetWritePointer(cBuffer_t* inst);
 
+/**
+ * Reserve space to write directly into the buffer
+ * Nothing is added to the buffer until cBufferCommitWrite is called
+ * Input: Pointer to buffer instance
+ * Input: Minimum number of contiguous bytes required
+ * Input: Pointer to store the pointer to the first free byte
+ * Input: Pointer to store the number of contiguous free bytes
+ * Returns: cBufferErr_t, C_BUFFER_INSUFFICIENT if less than min_size contiguous bytes are free
+ */
+int32_t cBufferReserveWrite(cBuffer_t* inst, size_t min_size, uint8_t **ptr, size_t *len);
+
+/**
+ * Get all free space in place as up to two regions, the second region is the
+ * space after the wrap. Use cBufferCommitWrite once data has been written.
+ * Input: Pointer to buffer instance
+ * Input: Array of C_BUFFER_NUM_REGIONS regions, unused regions are set to NULL and 0
+ * Returns: cBufferErr_t or number of regions holding free space
+ */
+int32_t cBufferGetWriteRegions(cBuffer_t* inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]);
+
+/**
+ * Add data written in place after cBufferReserveWrite or cBufferGetWriteRegions
+ * Input: Pointer to buffer instance
+ * Input: Number of bytes written
+ * Returns: cBufferErr_t or num bytes committed, C_BUFFER_INSUFFICIENT if more than the free space
+ */
+cBufferSsize_t cBufferCommitWrite(cBuffer_t* inst, size_t num_bytes);
+
 /**
  * Increment the amount of data in the buffer without writing anything to the buffer
  * Note: There is no garantuee that the data is continous
  * Input: Pointer to buffer instance
  * Input: Number of bytes to append to head
- * Returns: cBufferErr_t
+ * Returns: cBufferErr_t or num bytes added, C_BUFFER_INSUFFICIENT if more than the free space
  */
-int32_t cBufferEmptyWrite(cBuffer_t* inst, size_t num_bytes);
+cBufferSsize_t cBufferEmptyWrite(cBuffer_t* inst, size_t num_bytes);
 
 /**
  * Decrement the amount of data in the buffer without copying any data
@@ -225,7 +684,37 @@ int32_t cBufferEmptyWrite(cBuffer_t* inst, size_t num_bytes);
  * Input: Number of bytes to remove from to tail
  * Returns: cBufferErr_t
  */
-int32_t cBufferEmptyRead(cBuffer_t* inst, size_t num_bytes);
+cBufferSsize_t cBufferEmptyRead(cBuffer_t* inst, size_t num_bytes);
+
+/**
+ * Move data from one buffer to another without an intermediate copy
+ * The readable regions of src are copied straight into the free regions of dst,
+ * then the data is published in dst and consumed from src.
+ * Input: Pointer to the destination buffer instance
+ * Input: Pointer to the source buffer instance
+ * Input: Maximum number of bytes to move
+ * Returns: cBufferErr_t or num bytes moved, limited by the data in src and the space in dst
+ */
+cBufferSsize_t cBufferTransfer(cBuffer_t *dst, cBuffer_t *src, size_t max_len);
+
+#ifdef C_BUFFER_STATS
+/**
+ * Get a copy of the usage statistics of the buffer
+ * Note: The counters are not atomic, in SPSC mode bytes_out is updated by the
+ * consumer and the rest by the producer, so a snapshot may be slightly stale
+ * Input: Pointer to buffer instance
+ * Input: Pointer to the stats to fill in
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferGetStats(cBuffer_t *inst, cBufferStats_t *stats);
+
+/**
+ * Reset the usage statistics, the high watermark restarts at the current fill level
+ * Input: Pointer to buffer instance
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferResetStats(cBuffer_t *inst);
+#endif
 
 #ifdef __cplusplus
 }
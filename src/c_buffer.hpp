@@ -0,0 +1,176 @@
+/**
+ * @file:       c_buffer.hpp
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      C++ wrapper with a compile time capacity
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#ifndef C_BUFFER_HPP
+#define C_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include "c_buffer.h"
+
+/**
+ * CBuffer<N> owns an N byte array and a power of two cBuffer_t on top of it.
+ * N is known at compile time, so the byte level hot paths are inlined here
+ * with a constant mask, everything else calls into the C functions.
+ * Note: C_BUFFER_STATS builds route the inlined paths through the C functions
+ * so the counters stay correct.
+ * Note: Not thread safe, use get() with the C API for the SPSC and MPSC modes.
+ */
+template <size_t N>
+class CBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "CBuffer size must be a power of two");
+    static_assert(N <= C_BUFFER_MAX_SIZE, "CBuffer size must be no larger than C_BUFFER_MAX_SIZE");
+
+public:
+    using ReadRegions  = std::pair<std::span<const uint8_t>, std::span<const uint8_t>>;
+    using WriteRegions = std::pair<std::span<uint8_t>, std::span<uint8_t>>;
+
+    CBuffer() { cBufferInitPow2(&cb_, data_, N); }
+
+    CBuffer(const CBuffer &) = delete;
+    CBuffer &operator=(const CBuffer &) = delete;
+
+    // The array is inline, moving copies the stored bytes, the mode and the headroom and points the
+    // new instance at its own array
+    CBuffer(CBuffer &&other) noexcept : CBuffer() { moveFrom(other); }
+
+    CBuffer &operator=(CBuffer &&other) noexcept {
+        if (this != &other) {
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+    size_t size() const { return (size_t)(cBufferIndex_t)(cb_.head - cb_.tail); }
+    bool empty() const { return cb_.head == cb_.tail; }
+    bool full() const { return size() == N; }
+
+    // Returns: cBufferErr_t or 1 if one byte was written
+    int32_t appendByte(uint8_t data) {
+#ifdef C_BUFFER_STATS
+        return cBufferAppendByte(&cb_, data);
+#else
+        if (full()) {
+            return C_BUFFER_INSUFFICIENT;
+        }
+        data_[cb_.head & mask] = data;
+        cb_.head++;
+        return 1;
+#endif
+    }
+
+    // Returns: The next byte, 0 if the buffer is empty
+    uint8_t readByte() {
+#ifdef C_BUFFER_STATS
+        return cBufferReadByte(&cb_);
+#else
+        if (empty()) {
+            return 0;
+        }
+        uint8_t data = data_[cb_.tail & mask];
+        cb_.tail++;
+        return data;
+#endif
+    }
+
+    // Returns: The byte at offset from the tail, 0 if offset is past the stored data
+    uint8_t peekByte(size_t offset) const {
+        if (offset >= size()) {
+            return 0;
+        }
+        return data_[(cb_.tail + offset) & mask];
+    }
+
+    // Returns: cBufferErr_t or num bytes written, all or nothing
+    cBufferSsize_t append(std::span<const uint8_t> data) {
+        return cBufferAppend(&cb_, const_cast<uint8_t *>(data.data()), data.size());
+    }
+
+    // Returns: cBufferErr_t or num bytes written in front of the tail
+    cBufferSsize_t prepend(std::span<const uint8_t> data) {
+        return cBufferPrepend(&cb_, const_cast<uint8_t *>(data.data()), data.size());
+    }
+
+    // Fills all of data, returns cBufferErr_t or num bytes read
+    cBufferSsize_t read(std::span<uint8_t> data) {
+        return cBufferReadBytes(&cb_, data.data(), data.size());
+    }
+
+    // Fills all of data starting at offset from the tail without consuming anything
+    cBufferSsize_t peek(size_t offset, std::span<uint8_t> data) {
+        return cBufferPeek(&cb_, offset, data.data(), data.size());
+    }
+
+    // Stored data in place, the second span holds the data after the wrap
+    ReadRegions readRegions() const {
+        size_t pos   = cb_.tail & mask;
+        size_t used  = size();
+        size_t first = used < N - pos ? used : N - pos;
+        return {std::span<const uint8_t>(data_ + pos, first), std::span<const uint8_t>(data_, used - first)};
+    }
+
+    // Free space in place, publish written bytes with commitWrite
+    WriteRegions writeRegions() {
+        size_t pos      = cb_.head & mask;
+        size_t num_free = N - size();
+        size_t first    = num_free < N - pos ? num_free : N - pos;
+        return {std::span<uint8_t>(data_ + pos, first), std::span<uint8_t>(data_, num_free - first)};
+    }
+
+    cBufferSsize_t emptyRead(size_t num_bytes) { return cBufferEmptyRead(&cb_, num_bytes); }
+    cBufferSsize_t commitWrite(size_t num_bytes) { return cBufferCommitWrite(&cb_, num_bytes); }
+    int32_t clear() { return cBufferClear(&cb_); }
+
+    // The underlying instance for the rest of the C API
+    cBuffer_t *get() { return &cb_; }
+    const cBuffer_t *get() const { return &cb_; }
+
+private:
+    static constexpr size_t mask = N - 1;
+
+    void moveFrom(CBuffer &other) {
+        auto regions = other.readRegions();
+        // The mode and the headroom carry over, a DMA buffer stays with the
+        // hardware and the moved copy is a plain SPSC buffer of its bytes
+        cb_.mode     = other.cb_.mode & ~(uint32_t)C_BUFFER_MODE_DMA;
+        cb_.headroom = other.cb_.headroom;
+        cBufferClear(&cb_);
+        cBufferAppend(&cb_, const_cast<uint8_t *>(regions.first.data()), regions.first.size());
+        cBufferAppend(&cb_, const_cast<uint8_t *>(regions.second.data()), regions.second.size());
+        cBufferClear(&other.cb_);
+    }
+
+    uint8_t   data_[N];
+    cBuffer_t cb_;
+};
+
+#endif /* C_BUFFER_HPP */
@@ -0,0 +1,348 @@
+/**
+ * @file:       c_buffer_chain.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Implementation of a growable chain of circular buffers
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "c_buffer_chain.h"
+#include "string.h"
+
+// Blocks start with the segment header, the data follows at this offset
+#define SEGMENT_ALIGN offsetof(struct { char c; cBufferSegment_t s; }, s)
+#define SEGMENT_HEADER_SIZE ((sizeof(cBufferSegment_t) + SEGMENT_ALIGN - 1) / SEGMENT_ALIGN * SEGMENT_ALIGN)
+
+// Blocks are placed back to back, each padded to keep the next header aligned
+static size_t blockStride(size_t block_size)
+{
+    return (SEGMENT_HEADER_SIZE + block_size + SEGMENT_ALIGN - 1) / SEGMENT_ALIGN * SEGMENT_ALIGN;
+}
+
+static cBufferSegment_t *poolTake(cBufferPool_t *pool)
+{
+    cBufferSegment_t *segment = pool->free_list;
+    if (segment == NULL) {
+        return NULL;
+    }
+
+    pool->free_list = segment->next;
+    pool->num_free--;
+
+    // The data array lives right after the header
+    cBufferInitPow2(&segment->cb, (uint8_t *)segment + SEGMENT_HEADER_SIZE, pool->block_size);
+    segment->next = NULL;
+
+    return segment;
+}
+
+static void poolGive(cBufferPool_t *pool, cBufferSegment_t *segment)
+{
+    segment->next   = pool->free_list;
+    pool->free_list = segment;
+    pool->num_free++;
+}
+
+// Add a new empty segment to the end of the chain
+static cBufferSegment_t *chainGrow(cBufferChain_t *chain)
+{
+    cBufferSegment_t *segment = poolTake(chain->pool);
+    if (segment == NULL) {
+        return NULL;
+    }
+
+    if (chain->last == NULL) {
+        chain->first = segment;
+    } else {
+        chain->last->next = segment;
+    }
+    chain->last = segment;
+
+    return segment;
+}
+
+// Give the first segment back to the pool once it has been read empty
+static void chainShrink(cBufferChain_t *chain)
+{
+    cBufferSegment_t *segment = chain->first;
+
+    if (segment == NULL || !cBufferEmpty(&segment->cb)) {
+        return;
+    }
+
+    chain->first = segment->next;
+    if (chain->first == NULL) {
+        chain->last = NULL;
+    }
+
+    poolGive(chain->pool, segment);
+}
+
+size_t cBufferPoolMemorySize(size_t block_size, size_t num_blocks) {
+    // Leave room to align the first block
+    return blockStride(block_size) * num_blocks + SEGMENT_ALIGN - 1;
+}
+
+cBufferSsize_t cBufferPoolInit(cBufferPool_t *pool, uint8_t *memory, size_t memory_size, size_t block_size) {
+    if (pool == NULL || memory == NULL || block_size == 0) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    // Each segment is a power of two buffer so the full block can be used
+    if ((block_size & (block_size - 1)) != 0 || block_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t skip = (SEGMENT_ALIGN - (uintptr_t)memory % SEGMENT_ALIGN) % SEGMENT_ALIGN;
+    size_t stride = blockStride(block_size);
+
+    pool->free_list  = NULL;
+    pool->block_size = block_size;
+    pool->num_blocks = memory_size > skip ? (memory_size - skip) / stride : 0;
+    pool->num_free   = 0;
+
+    if (pool->num_blocks == 0 || pool->num_blocks > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Put the blocks on the free list in address order
+    for (size_t ind = pool->num_blocks; ind > 0; ind--) {
+        poolGive(pool, (cBufferSegment_t *)(memory + skip + (ind - 1) * stride));
+    }
+
+    return pool->num_blocks;
+}
+
+cBufferSsize_t cBufferPoolAvailable(cBufferPool_t *pool) {
+    if (pool == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return pool->num_free;
+}
+
+int32_t cBufferChainInit(cBufferChain_t *chain, cBufferPool_t *pool) {
+    if (chain == NULL || pool == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    chain->pool      = pool;
+    chain->first     = NULL;
+    chain->last      = NULL;
+    chain->num_bytes = 0;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferChainClear(cBufferChain_t *chain) {
+    if (chain == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    while (chain->first != NULL) {
+        cBufferSegment_t *segment = chain->first;
+        chain->first = segment->next;
+        poolGive(chain->pool, segment);
+    }
+
+    chain->last      = NULL;
+    chain->num_bytes = 0;
+
+    return C_BUFFER_SUCCESS;
+}
+
+cBufferSsize_t cBufferChainAvailableForRead(cBufferChain_t *chain) {
+    if (chain == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (chain->num_bytes > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MAX_SIZE;
+    }
+
+    return chain->num_bytes;
+}
+
+// Free space in the last segment plus everything the pool can still hand out
+static size_t chainFree(const cBufferChain_t *chain)
+{
+    size_t num_free = chain->pool->num_free * chain->pool->block_size;
+
+    if (chain->last != NULL) {
+        num_free += cBufferAvailableForWrite(&chain->last->cb);
+    }
+
+    return num_free;
+}
+
+cBufferSsize_t cBufferChainAvailableForWrite(cBufferChain_t *chain) {
+    if (chain == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    size_t num_free = chainFree(chain);
+    if (num_free > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MAX_SIZE;
+    }
+
+    return num_free;
+}
+
+cBufferSsize_t cBufferChainAppend(cBufferChain_t *chain, uint8_t *data, size_t data_size) {
+    if (chain == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (data_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    // All or nothing, check before any segment is taken
+    if (chainFree(chain) < data_size) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    size_t written = 0;
+    while (written < data_size) {
+        size_t num_free = chain->last != NULL ? (size_t)cBufferAvailableForWrite(&chain->last->cb) : 0;
+
+        if (num_free == 0) {
+            // Can't fail as the free space was checked
+            chainGrow(chain);
+            num_free = chain->pool->block_size;
+        }
+
+        size_t chunk = data_size - written < num_free ? data_size - written : num_free;
+        cBufferAppend(&chain->last->cb, data + written, chunk);
+        written += chunk;
+    }
+
+    chain->num_bytes += data_size;
+
+    return data_size;
+}
+
+cBufferSsize_t cBufferChainReadBytes(cBufferChain_t *chain, uint8_t *data, size_t read_size) {
+    if (chain == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (read_size > chain->num_bytes || read_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t num_read = 0;
+    while (num_read < read_size) {
+        size_t in_segment = cBufferAvailableForRead(&chain->first->cb);
+        size_t chunk = read_size - num_read < in_segment ? read_size - num_read : in_segment;
+
+        cBufferReadBytes(&chain->first->cb, data + num_read, chunk);
+        num_read += chunk;
+        chainShrink(chain);
+    }
+
+    chain->num_bytes -= read_size;
+
+    return read_size;
+}
+
+cBufferSsize_t cBufferChainEmptyRead(cBufferChain_t *chain, size_t num_bytes) {
+    if (chain == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (num_bytes > chain->num_bytes || num_bytes > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    size_t num_read = 0;
+    while (num_read < num_bytes) {
+        size_t in_segment = cBufferAvailableForRead(&chain->first->cb);
+        size_t chunk = num_bytes - num_read < in_segment ? num_bytes - num_read : in_segment;
+
+        cBufferEmptyRead(&chain->first->cb, chunk);
+        num_read += chunk;
+        chainShrink(chain);
+    }
+
+    chain->num_bytes -= num_bytes;
+
+    return num_bytes;
+}
+
+int32_t cBufferChainGetReadRegions(cBufferChain_t *chain, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]) {
+    if (chain == NULL || regions == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (chain->first == NULL) {
+        regions[0].data = NULL;
+        regions[0].size = 0;
+        regions[1].data = NULL;
+        regions[1].size = 0;
+        return 0;
+    }
+
+    return cBufferGetReadRegions(&chain->first->cb, regions);
+}
+
+int32_t cBufferChainReserveWrite(cBufferChain_t *chain, size_t min_size, uint8_t **ptr, size_t *len) {
+    if (chain == NULL || ptr == NULL || len == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (min_size > chain->pool->block_size) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    if (chain->last != NULL && cBufferReserveWrite(&chain->last->cb, min_size, ptr, len) == C_BUFFER_SUCCESS) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    // Start a new segment, the rest of the last one is left unused
+    cBufferSegment_t *segment = chainGrow(chain);
+    if (segment == NULL) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    return cBufferReserveWrite(&segment->cb, min_size, ptr, len);
+}
+
+cBufferSsize_t cBufferChainCommitWrite(cBufferChain_t *chain, size_t num_bytes) {
+    if (chain == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (chain->last == NULL) {
+        return num_bytes == 0 ? C_BUFFER_SUCCESS : C_BUFFER_INSUFFICIENT;
+    }
+
+    cBufferSsize_t res = cBufferCommitWrite(&chain->last->cb, num_bytes);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    chain->num_bytes += num_bytes;
+
+    return res;
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+/**
+ * @file:       c_buffer_chain.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Growable chain of circular buffers backed by a fixed block pool
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+
+#ifndef C_BUFFER_CHAIN_H
+#define C_BUFFER_CHAIN_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+/**
+ * A chain stores a byte stream in fixed size segments taken from a pool that is
+ * shared between many chains. Segments are added as data is appended and given
+ * back to the pool as soon as they have been read empty, so memory follows the
+ * amount of live data instead of the worst case of every chain.
+ * Note: Pools and chains are not thread safe, use them from one context.
+ */
+
+typedef struct cBufferSegment {
+    struct cBufferSegment *next;
+    cBuffer_t cb;
+} cBufferSegment_t;
+
+typedef struct {
+    cBufferSegment_t *free_list;
+    size_t block_size;
+    size_t num_blocks;
+    size_t num_free;
+} cBufferPool_t;
+
+typedef struct {
+    cBufferPool_t *pool;
+    cBufferSegment_t *first; // Segment that is read from
+    cBufferSegment_t *last;  // Segment that is written to
+    size_t num_bytes;
+} cBufferChain_t;
+
+/**
+ * Get the number of bytes of pool memory needed for a number of blocks
+ * Input: Size of each block, must be a power of two
+ * Input: Number of blocks
+ * Returns: Size of the memory to pass to cBufferPoolInit
+ */
+size_t cBufferPoolMemorySize(size_t block_size, size_t num_blocks);
+
+/**
+ * Initialize a pool by splitting the memory into blocks
+ * Every block keeps its segment header in front of the data
+ * Input: Pointer to pool instance
+ * Input: Pointer to the pool memory
+ * Input: Size of the pool memory
+ * Input: Size of the data in each block, must be a power of two
+ * Returns: cBufferErr_t or the number of blocks, C_BUFFER_MISMATCH if the block
+ *          size is not a power of two and C_BUFFER_INSUFFICIENT if no block fits
+ */
+cBufferSsize_t cBufferPoolInit(cBufferPool_t *pool, uint8_t *memory, size_t memory_size, size_t block_size);
+
+/**
+ * Get the number of free blocks in the pool
+ * Input: Pointer to pool instance
+ * Returns: cBufferErr_t or number of free blocks
+ */
+cBufferSsize_t cBufferPoolAvailable(cBufferPool_t *pool);
+
+/**
+ * Initialize an empty chain, no blocks are taken until data is written
+ * Input: Pointer to chain instance
+ * Input: Pointer to the pool to take blocks from
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferChainInit(cBufferChain_t *chain, cBufferPool_t *pool);
+
+/**
+ * Give all blocks of the chain back to the pool, the data is dropped
+ * Input: Pointer to chain instance
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferChainClear(cBufferChain_t *chain);
+
+/**
+ * Get number of bytes available for read
+ * Input: Pointer to chain instance
+ * Returns: cBufferErr_t or number of bytes in the chain
+ */
+cBufferSsize_t cBufferChainAvailableForRead(cBufferChain_t *chain);
+
+/**
+ * Get number of bytes that can be appended, the last segment and the free blocks of the pool
+ * Input: Pointer to chain instance
+ * Returns: cBufferErr_t or number of bytes
+ */
+cBufferSsize_t cBufferChainAvailableForWrite(cBufferChain_t *chain);
+
+/**
+ * Append data to the end of the chain, new segments are taken from the pool as needed
+ * Input: Pointer to chain instance
+ * Input: Pointer to data
+ * Input: Size of data
+ * Returns: cBufferErr_t or num bytes added, C_BUFFER_INSUFFICIENT if the pool can't hold all of it
+ */
+cBufferSsize_t cBufferChainAppend(cBufferChain_t *chain, uint8_t *data, size_t data_size);
+
+/**
+ * Read and consume data from the front of the chain, empty segments go back to the pool
+ * Input: Pointer to chain instance
+ * Input: Pointer to data to read into
+ * Input: Number of bytes to read
+ * Returns: cBufferErr_t or num bytes read, C_BUFFER_MISMATCH if there is less data
+ */
+cBufferSsize_t cBufferChainReadBytes(cBufferChain_t *chain, uint8_t *data, size_t read_size);
+
+/**
+ * Consume data without copying it, empty segments go back to the pool
+ * Input: Pointer to chain instance
+ * Input: Number of bytes to consume
+ * Returns: cBufferErr_t or num bytes consumed, C_BUFFER_MISMATCH if there is less data
+ */
+cBufferSsize_t cBufferChainEmptyRead(cBufferChain_t *chain, size_t num_bytes);
+
+/**
+ * Get the readable data of the first segment in place as up to two regions
+ * Nothing is consumed, use cBufferChainEmptyRead and call again for the next segment.
+ * Input: Pointer to chain instance
+ * Input: Array of C_BUFFER_NUM_REGIONS regions, unused regions are set to NULL and 0
+ * Returns: cBufferErr_t or the number of regions that hold data
+ */
+int32_t cBufferChainGetReadRegions(cBufferChain_t *chain, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]);
+
+/**
+ * Reserve contiguous space at the end of the chain to write into directly
+ * A new segment is taken if the last one has less than min_size contiguous bytes free.
+ * Publish the written bytes with cBufferChainCommitWrite.
+ * Input: Pointer to chain instance
+ * Input: Minimum number of contiguous bytes needed, at most the block size
+ * Input: Pointer to the returned write pointer
+ * Input: Pointer to the returned number of contiguous bytes
+ * Returns: cBufferErr_t, C_BUFFER_INSUFFICIENT if no space could be found
+ */
+int32_t cBufferChainReserveWrite(cBufferChain_t *chain, size_t min_size, uint8_t **ptr, size_t *len);
+
+/**
+ * Publish bytes written into the space returned by cBufferChainReserveWrite
+ * Input: Pointer to chain instance
+ * Input: Number of bytes written
+ * Returns: cBufferErr_t or num bytes added, C_BUFFER_INSUFFICIENT if more than was reserved
+ */
+cBufferSsize_t cBufferChainCommitWrite(cBufferChain_t *chain, size_t num_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_CHAIN_H */
\ No newline at end of file
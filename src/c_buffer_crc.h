@@ -0,0 +1,88 @@
+/**
+ * @file:       c_buffer_crc.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      CRC and checksums over data in a circular buffer
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+
+#ifndef C_BUFFER_CRC_H
+#define C_BUFFER_CRC_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+/**
+ * The checksums are computed in place over both regions of the buffer, nothing
+ * is copied or consumed. The range is given as an offset from the first byte in
+ * the buffer and a length, like cBufferPeek.
+ */
+
+// Called with each contiguous span of the range in order, state is passed through
+typedef void (*cBufferChecksumCb_t)(void *state, const uint8_t *data, size_t size);
+
+/**
+ * Calculate the CRC-32 (IEEE 802.3, as used by zlib and Ethernet) of a range
+ * A previous result can be passed as seed to continue over several ranges.
+ * Uses the ARM CRC32 instructions when __ARM_FEATURE_CRC32 is set, otherwise
+ * slicing by 4 tables, or a single table with C_BUFFER_CRC_SMALL.
+ * Input: Pointer to buffer instance
+ * Input: Offset from the first byte in the buffer
+ * Input: Number of bytes in the range
+ * Input: Seed, 0 to start a new CRC
+ * Input: Pointer to the returned CRC
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the range is outside the data
+ */
+int32_t cBufferCrc32(cBuffer_t *inst, size_t offset, size_t len, uint32_t seed, uint32_t *crc);
+
+/**
+ * Calculate the CRC-16/CCITT (polynomial 0x1021, no reflection) of a range
+ * Input: Pointer to buffer instance
+ * Input: Offset from the first byte in the buffer
+ * Input: Number of bytes in the range
+ * Input: Seed, 0xFFFF for CCITT-FALSE, 0 for XMODEM or a previous result to continue
+ * Input: Pointer to the returned CRC
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the range is outside the data
+ */
+int32_t cBufferCrc16(cBuffer_t *inst, size_t offset, size_t len, uint16_t seed, uint16_t *crc);
+
+/**
+ * Run any checksum over a range, the callback gets each contiguous span in order
+ * Input: Pointer to buffer instance
+ * Input: Offset from the first byte in the buffer
+ * Input: Number of bytes in the range
+ * Input: Callback that updates the checksum
+ * Input: Checksum state passed to the callback
+ * Returns: cBufferErr_t, C_BUFFER_MISMATCH if the range is outside the data
+ */
+int32_t cBufferChecksum(cBuffer_t *inst, size_t offset, size_t len, cBufferChecksumCb_t cb, void *state);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_CRC_H */
\ No newline at end of file
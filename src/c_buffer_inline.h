@@ -0,0 +1,310 @@
+/**
+ * @file:       c_buffer_inline.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Inline index helpers and unchecked byte level fast path
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_INLINE_H
+#define C_BUFFER_INLINE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "c_buffer.h"
+#ifndef NO_MEMCPY
+#include <string.h>
+#endif
+
+/**
+ * The index math of c_buffer.c is kept here so that the unchecked variants
+ * below follow the exact same rules for every buffer mode.
+ *
+ * The unchecked variants skip the NULL checks, the space checks and the
+ * empty buffer reset. They are meant for tight loops, e.g. in an ISR, after
+ * one bulk check of cBufferAvailableForWrite or cBufferAvailableForRead.
+ * Note: They do not update the C_BUFFER_STATS counters.
+ * Note: cBufferAppendByteUnchecked is not safe for MPSC producers.
+ */
+
+// Translate a head or tail index to a position in the data array
+static inline size_t cBufferIndexToPos(const cBuffer_t *inst, cBufferIndex_t index)
+{
+    if (inst->mode & C_BUFFER_MODE_POW2) {
+        return index & (inst->size - 1);
+    }
+
+    return index;
+}
+
+static inline cBufferIndex_t cBufferIndexInc(const cBuffer_t *inst, cBufferIndex_t index, size_t increment)
+{
+    if (inst->mode & C_BUFFER_MODE_POW2) {
+        // The counters are free running, the mask is applied on access
+        return index + (cBufferIndex_t)increment;
+    }
+
+    return (index + increment) % inst->size;
+}
+
+static inline cBufferIndex_t cBufferIndexDec(const cBuffer_t *inst, cBufferIndex_t index, size_t decrement)
+{
+    if (inst->mode & C_BUFFER_MODE_POW2) {
+        return index - (cBufferIndex_t)decrement;
+    }
+
+    return (index + inst->size - (decrement % inst->size)) % inst->size;
+}
+
+// Acquire loads and release stores of the shared indexes. GCC and clang use the
+// __atomic builtins, other compilers need C11 atomics from <stdatomic.h>.
+#if defined(__GNUC__) || defined(__clang__)
+static inline cBufferIndex_t cBufferLoadAcquire(const cBufferIndex_t *index)
+{
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static inline void cBufferStoreRelease(cBufferIndex_t *index, cBufferIndex_t value)
+{
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+static inline void cBufferFenceAcquire(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+// The indexes are plain integers in cBuffer_t, they have the layout of their atomic type
+static inline cBufferIndex_t cBufferLoadAcquire(const cBufferIndex_t *index)
+{
+    return atomic_load_explicit((_Atomic cBufferIndex_t *)index, memory_order_acquire);
+}
+
+static inline void cBufferStoreRelease(cBufferIndex_t *index, cBufferIndex_t value)
+{
+    atomic_store_explicit((_Atomic cBufferIndex_t *)index, value, memory_order_release);
+}
+
+static inline void cBufferFenceAcquire(void)
+{
+    atomic_thread_fence(memory_order_acquire);
+}
+#else
+#error "c_buffer needs GCC, clang or a C11 compiler with <stdatomic.h>"
+#endif
+
+// In SPSC mode the index owned by the other side is loaded with acquire semantics,
+// so the data written before it was published is visible. The owner of an index
+// may read it directly as it is the only writer.
+static inline cBufferIndex_t cBufferLoadHead(const cBuffer_t *inst)
+{
+#ifdef C_BUFFER_DMA
+    if (inst->mode & C_BUFFER_MODE_DMA) {
+        // The hardware reports an array position, place it at most one lap ahead of tail
+        cBufferIndex_t tail = inst->tail;
+        cBufferIndex_t pos  = inst->head_cb(inst->head_ctx);
+        cBufferFenceAcquire();
+        return tail + ((pos - tail) & (cBufferIndex_t)(inst->size - 1));
+    }
+#endif
+
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        return cBufferLoadAcquire(&inst->head);
+    }
+
+    return inst->head;
+}
+
+static inline cBufferIndex_t cBufferLoadTail(const cBuffer_t *inst)
+{
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        return cBufferLoadAcquire(&inst->tail);
+    }
+
+    return inst->tail;
+}
+
+// Publish a new index, in SPSC mode all data accesses before this are ordered before it
+static inline void cBufferStoreHead(cBuffer_t *inst, cBufferIndex_t head)
+{
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        cBufferStoreRelease(&inst->head, head);
+    } else {
+        inst->head = head;
+    }
+}
+
+static inline void cBufferStoreTail(cBuffer_t *inst, cBufferIndex_t tail)
+{
+    if (inst->mode & C_BUFFER_MODE_SPSC) {
+        cBufferStoreRelease(&inst->tail, tail);
+    } else {
+        inst->tail = tail;
+    }
+}
+
+// Number of bytes stored between tail and head
+static inline size_t cBufferUsedBytes(const cBuffer_t *inst, cBufferIndex_t head, cBufferIndex_t tail)
+{
+    if (inst->mode & C_BUFFER_MODE_POW2) {
+        return head - tail;
+    }
+
+    if (head < tail) {
+        return (inst->size - tail) + head;
+    }
+
+    return head - tail;
+}
+
+#ifdef NO_MEMCPY
+/**
+ * Copy bytes a word at a time without libc, used by cBufferCopyBytes
+ * Input: Pointer to the destination
+ * Input: Pointer to the source, must not overlap the destination
+ * Input: Number of bytes to copy
+ */
+void cBufferCopyWords(uint8_t *dst, const uint8_t *src, size_t size);
+#endif
+
+/**
+ * Copy bytes between two memory areas that do not overlap
+ * Note: With NO_MEMCPY long copies use cBufferCopyWords, otherwise libc memcpy
+ * Input: Pointer to the destination
+ * Input: Pointer to the source
+ * Input: Number of bytes to copy
+ */
+#ifdef NO_MEMCPY
+static inline void cBufferCopyBytes(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    // Short copies stay inline, they are done before any word could be aligned
+    if (size >= 4 * sizeof(uintptr_t)) {
+        cBufferCopyWords(dst, src, size);
+        return;
+    }
+
+    for (size_t ind = 0; ind < size; ind++) {
+        dst[ind] = src[ind];
+    }
+}
+#else
+static inline void cBufferCopyBytes(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    memcpy(dst, src, size);
+}
+#endif
+
+// Number of bytes that can be accessed from the start of the array before wrapping
+static inline size_t cBufferLinearSize(const cBuffer_t *inst)
+{
+    if (inst->mode & C_BUFFER_MODE_MIRRORED) {
+        return 2 * inst->size;
+    }
+
+    return inst->size;
+}
+
+// Maximum number of bytes that can be stored in the buffer
+static inline size_t cBufferCapacity(const cBuffer_t *inst)
+{
+    if (inst->mode & C_BUFFER_MODE_POW2) {
+        return inst->size - C_BUFFER_POW2_ARRAY_OVERHEAD;
+    }
+
+    return inst->size - C_BUFFER_ARRAY_OVERHEAD;
+}
+
+/**
+ * Get number of bytes available for read without checking the instance
+ * Input: Pointer to a valid buffer instance
+ * Returns: Number of bytes in the buffer
+ */
+static inline size_t cBufferAvailableForReadUnchecked(const cBuffer_t *inst)
+{
+    return cBufferUsedBytes(inst, cBufferLoadHead(inst), cBufferLoadTail(inst));
+}
+
+/**
+ * Get number of bytes available for write without checking the instance
+ * Input: Pointer to a valid buffer instance
+ * Returns: Number of free bytes in the buffer
+ */
+static inline size_t cBufferAvailableForWriteUnchecked(const cBuffer_t *inst)
+{
+    return cBufferCapacity(inst) - cBufferAvailableForReadUnchecked(inst);
+}
+
+/**
+ * Check if the buffer is empty without checking the instance
+ * Input: Pointer to a valid buffer instance
+ * Returns: 1 if empty, otherwise 0
+ */
+static inline int32_t cBufferEmptyUnchecked(const cBuffer_t *inst)
+{
+    return cBufferLoadHead(inst) == cBufferLoadTail(inst);
+}
+
+/**
+ * Check if the buffer is full without checking the instance
+ * Input: Pointer to a valid buffer instance
+ * Returns: 1 if full, otherwise 0
+ */
+static inline int32_t cBufferFullUnchecked(const cBuffer_t *inst)
+{
+    return cBufferAvailableForReadUnchecked(inst) == cBufferCapacity(inst);
+}
+
+/**
+ * Append a byte to the buffer without any checks
+ * Note: The caller must make sure that there is at least one free byte
+ * Input: Pointer to a valid buffer instance
+ * Input: Byte to append
+ */
+static inline void cBufferAppendByteUnchecked(cBuffer_t *inst, uint8_t data)
+{
+    inst->data[cBufferIndexToPos(inst, inst->head)] = data;
+    cBufferStoreHead(inst, cBufferIndexInc(inst, inst->head, 1));
+}
+
+/**
+ * Read a byte from the buffer without any checks
+ * Note: The caller must make sure that the buffer is not empty
+ * Input: Pointer to a valid buffer instance
+ * Returns: The oldest byte in the buffer
+ */
+static inline uint8_t cBufferReadByteUnchecked(cBuffer_t *inst)
+{
+    uint8_t data = inst->data[cBufferIndexToPos(inst, inst->tail)];
+    cBufferStoreTail(inst, cBufferIndexInc(inst, inst->tail, 1));
+
+    return data;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_INLINE_H */
\ No newline at end of file
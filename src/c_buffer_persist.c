@@ -0,0 +1,161 @@
+/**
+ * @file:       c_buffer_persist.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Circular buffer kept in memory that survives a crash or reset
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "c_buffer_persist.h"
+
+#define PERSIST_MODE (C_BUFFER_MODE_POW2 | C_BUFFER_MODE_SPSC)
+
+static size_t alignUp(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+// The instance follows the header and the data array follows the instance
+static size_t instOffset(void)
+{
+    return alignUp(sizeof(cBufferPersistHeader_t), _Alignof(cBuffer_t));
+}
+
+static size_t dataOffset(void)
+{
+    return alignUp(instOffset() + sizeof(cBuffer_t), sizeof(uint64_t));
+}
+
+// The largest power of two data array that fits in the region, 0 if none does
+static size_t dataSize(size_t region_size)
+{
+    if (region_size <= dataOffset()) {
+        return 0;
+    }
+
+    size_t available = region_size - dataOffset();
+    size_t size      = 1;
+    while (size <= available / 2 && size * 2 <= C_BUFFER_MAX_SIZE) {
+        size *= 2;
+    }
+
+    return size;
+}
+
+static int32_t checkRegion(void *region, size_t region_size, cBuffer_t **inst)
+{
+    if (region == NULL || inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if ((uintptr_t)region & (_Alignof(cBuffer_t) - 1)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    if (dataSize(region_size) == 0) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    return C_BUFFER_SUCCESS;
+}
+
+// Everything below is O(1), the stored data itself is never looked at
+static int isValid(const cBufferPersistHeader_t *header, const cBuffer_t *cb, size_t region_size)
+{
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != C_BUFFER_PERSIST_MAGIC) {
+        return 0;
+    }
+
+    if (header->version != C_BUFFER_PERSIST_VERSION || header->layout_size != sizeof(cBuffer_t) ||
+        header->data_offset != dataOffset() || header->size != dataSize(region_size)) {
+        return 0;
+    }
+
+    if (cb->size != header->size || cb->mode != PERSIST_MODE) {
+        return 0;
+    }
+
+    // The free running indexes can never be further apart than the size
+    return (size_t)(cBufferIndex_t)(cb->head - cb->tail) <= cb->size;
+}
+
+int32_t cBufferPersistFormat(void *region, size_t region_size, cBuffer_t **inst) {
+    int32_t res = checkRegion(region, region_size, inst);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    cBufferPersistHeader_t *header = (cBufferPersistHeader_t *)region;
+    cBuffer_t *cb = (cBuffer_t *)((uint8_t *)region + instOffset());
+
+    // Keep counting generations if the region held a persistent buffer before
+    uint32_t generation = header->magic == C_BUFFER_PERSIST_MAGIC ? header->generation + 1 : 1;
+
+    // A format interrupted by a crash must not look valid
+    __atomic_store_n(&header->magic, 0, __ATOMIC_RELEASE);
+
+    header->version     = C_BUFFER_PERSIST_VERSION;
+    header->layout_size = sizeof(cBuffer_t);
+    header->generation  = generation;
+    header->data_offset = (uint32_t)dataOffset();
+    header->size        = dataSize(region_size);
+
+    res = cBufferInitSpsc(cb, (uint8_t *)region + dataOffset(), dataSize(region_size));
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    __atomic_store_n(&header->magic, C_BUFFER_PERSIST_MAGIC, __ATOMIC_RELEASE);
+    *inst = cb;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferPersistOpen(void *region, size_t region_size, cBuffer_t **inst) {
+    int32_t res = checkRegion(region, region_size, inst);
+    if (res != C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    cBufferPersistHeader_t *header = (cBufferPersistHeader_t *)region;
+    cBuffer_t *cb = (cBuffer_t *)((uint8_t *)region + instOffset());
+
+    if (!isValid(header, cb, region_size)) {
+        res = cBufferPersistFormat(region, region_size, inst);
+        return res == C_BUFFER_SUCCESS ? 1 : res;
+    }
+
+    // The region may be mapped at a new address, and a reservation that was
+    // never published is dropped
+    cb->data = (uint8_t *)region + dataOffset();
+#ifdef C_BUFFER_MPSC
+    cb->reserve = cb->head;
+#endif
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+    cb->cached_tail = cb->tail;
+    cb->cached_head = cb->head;
+#endif
+    *inst = cb;
+
+    return C_BUFFER_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file:       c_buffer_persist.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Circular buffer kept in memory that survives a crash or reset
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_PERSIST_H
+#define C_BUFFER_PERSIST_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+/**
+ * A persistent buffer keeps a header, the cBuffer_t itself and the data array
+ * in one caller provided region, e.g. a retained RAM or no init section on an
+ * MCU, or a shared file mapping, see cBufferPersistMapFile in c_buffer_posix.h.
+ *
+ * The buffer runs in SPSC mode, so data is always stored before the head that
+ * publishes it and read before the tail that frees it. Whatever point a crash
+ * interrupts, the indexes in the region describe complete data. Reopening only
+ * checks the header and the indexes, it does not depend on the amount of data.
+ * Note: The layout depends on the build options, a region written by a build
+ *       with other C_BUFFER_* options is formatted again
+ */
+
+#define C_BUFFER_PERSIST_MAGIC   0x63427546
+#define C_BUFFER_PERSIST_VERSION 1
+
+typedef struct {
+    uint32_t magic;       // Written last when formatting
+    uint16_t version;
+    uint16_t layout_size; // sizeof(cBuffer_t) of the build that formatted the region
+    uint32_t generation;  // Incremented every time the region is formatted
+    uint32_t data_offset; // Offset of the data array from the start of the region
+    uint64_t size;        // Size of the data array
+} cBufferPersistHeader_t;
+
+/**
+ * Open a persistent buffer, resuming the stored data if the region holds a valid one
+ * The data array is the largest power of two that fits after the header.
+ * Input: Pointer to the region, aligned like a cBuffer_t
+ * Input: Size of the region
+ * Input: Pointer to store the buffer instance, it lives in the region
+ * Returns: cBufferErr_t, 0 if the data was resumed and 1 if the region was formatted.
+ *          C_BUFFER_INSUFFICIENT if the region has no room for data and
+ *          C_BUFFER_MISMATCH if it is not aligned
+ */
+int32_t cBufferPersistOpen(void *region, size_t region_size, cBuffer_t **inst);
+
+/**
+ * Format the region as an empty persistent buffer, discarding any stored data
+ * Input: Pointer to the region, aligned like a cBuffer_t
+ * Input: Size of the region
+ * Input: Pointer to store the buffer instance, it lives in the region
+ * Returns: cBufferErr_t, C_BUFFER_INSUFFICIENT if the region has no room for data and
+ *          C_BUFFER_MISMATCH if it is not aligned
+ */
+int32_t cBufferPersistFormat(void *region, size_t region_size, cBuffer_t **inst);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_PERSIST_H */
@@ -0,0 +1,311 @@
+/**
+ * @file:       c_buffer_posix.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Implementation of POSIX specific circular buffer helpers
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "c_buffer_posix.h"
+#include "c_buffer_stats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+#endif
+
+// Translate buffer regions to an io vector, returns the number of vectors
+static int regionsToIovec(const cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], int num_regions,
+                          struct iovec iov[C_BUFFER_NUM_REGIONS])
+{
+    for (int i = 0; i < num_regions; i++) {
+        iov[i].iov_base = regions[i].data;
+        iov[i].iov_len  = regions[i].size;
+    }
+
+    return num_regions;
+}
+
+int32_t cBufferInitMirrored(cBuffer_t *inst, size_t min_size) {
+    if (inst == NULL || min_size == 0) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+#ifdef __linux__
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    // Both mappings must start on a page, and the power of two mode is used for the index math
+    size_t size = (size_t)page_size;
+    while (size < min_size) {
+        if (size > C_BUFFER_MAX_SIZE / 2) {
+            return C_BUFFER_MISMATCH;
+        }
+        size = size * 2;
+    }
+
+    int fd = memfd_create("c_buffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    // Reserve address space for both mappings, then place the same pages twice in it
+    uint8_t *base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        int err = errno;
+        munmap(base, 2 * size);
+        close(fd);
+        errno = err;
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    // The mappings keep the memory alive
+    close(fd);
+
+    int32_t res = cBufferInitPow2(inst, base, size);
+    if (res != C_BUFFER_SUCCESS) {
+        munmap(base, 2 * size);
+        return res;
+    }
+
+    inst->mode |= C_BUFFER_MODE_MIRRORED;
+
+    return C_BUFFER_SUCCESS;
+#else
+    errno = ENOSYS;
+    return C_BUFFER_SYSTEM_ERROR;
+#endif
+}
+
+int32_t cBufferDeinitMirrored(cBuffer_t *inst) {
+    if (inst == NULL || inst->data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (!(inst->mode & C_BUFFER_MODE_MIRRORED)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    if (munmap(inst->data, 2 * inst->size) != 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    inst->data = NULL;
+    inst->size = 0;
+    inst->head = 0;
+    inst->tail = 0;
+    inst->mode = 0;
+
+    return C_BUFFER_SUCCESS;
+}
+
+cBufferSsize_t cBufferReadFromFd(cBuffer_t *inst, int fd) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+    struct iovec iov[C_BUFFER_NUM_REGIONS];
+
+    int32_t num_regions = cBufferGetWriteRegions(inst, regions);
+    if (num_regions < C_BUFFER_SUCCESS) {
+        return num_regions;
+    }
+
+    if (num_regions == 0) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    ssize_t res;
+    do {
+        res = readv(fd, iov, regionsToIovec(regions, num_regions, iov));
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return C_BUFFER_WOULD_BLOCK;
+        }
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    return cBufferCommitWrite(inst, (size_t)res);
+}
+
+cBufferSsize_t cBufferWriteToFd(cBuffer_t *inst, int fd) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+    struct iovec iov[C_BUFFER_NUM_REGIONS];
+
+    int32_t num_regions = cBufferGetReadRegions(inst, regions);
+    if (num_regions <= 0) {
+        return num_regions;
+    }
+
+    ssize_t res;
+    do {
+        res = writev(fd, iov, regionsToIovec(regions, num_regions, iov));
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return C_BUFFER_WOULD_BLOCK;
+        }
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    return cBufferEmptyRead(inst, (size_t)res);
+}
+
+int32_t cBufferPersistMapFile(const char *path, size_t region_size, void **region) {
+    if (path == NULL || region == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (region_size == 0) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    // Only grow the file, a shorter one is padded with zeros and formatted by cBufferPersistOpen
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        ((size_t)file_stat.st_size < region_size && ftruncate(fd, (off_t)region_size) != 0)) {
+        close(fd);
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    void *base = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    *region = base;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferPersistFlush(void *region, size_t region_size) {
+    if (region == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    // The header and the indexes are in front of the data, find the page they end in
+    const cBufferPersistHeader_t *header = (const cBufferPersistHeader_t *)region;
+    size_t meta_end = region_size;
+    if (header->data_offset < region_size) {
+        meta_end = ((size_t)header->data_offset + (size_t)page_size - 1) / (size_t)page_size * (size_t)page_size;
+        meta_end = meta_end < region_size ? meta_end : region_size;
+    }
+
+    // Write the data before the indexes that cover it
+    if (meta_end < region_size && msync((uint8_t *)region + meta_end, region_size - meta_end, MS_SYNC) != 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    if (msync(region, meta_end, MS_SYNC) != 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferPersistUnmapFile(void *region, size_t region_size) {
+    if (region == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (munmap(region, region_size) != 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    return C_BUFFER_SUCCESS;
+}
+
+#ifdef __linux__
+static int32_t futexWait(void *ctx, uint32_t *word, uint32_t expected, int32_t timeout_ms)
+{
+    struct timespec timeout;
+    struct timespec *timeout_ptr = NULL;
+    (void)ctx;
+
+    if (timeout_ms >= 0) {
+        timeout.tv_sec  = timeout_ms / 1000;
+        timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        timeout_ptr     = &timeout;
+    }
+
+    if (syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, timeout_ptr, NULL, 0) == 0) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    // The word already changed or a signal arrived, the caller checks again
+    if (errno == EAGAIN || errno == EINTR) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    if (errno == ETIMEDOUT) {
+        return C_BUFFER_WOULD_BLOCK;
+    }
+
+    return C_BUFFER_SYSTEM_ERROR;
+}
+
+static void futexWake(void *ctx, uint32_t *word)
+{
+    (void)ctx;
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+const cBufferWaitHooks_t cBufferWaitFutexHooks = {
+    .wait = futexWait,
+    .wake = futexWake,
+    .ctx  = NULL,
+};
+#endif
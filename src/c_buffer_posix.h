@@ -0,0 +1,129 @@
+/**
+ * @file:       c_buffer_posix.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Header file for POSIX specific circular buffer helpers
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_POSIX_H
+#define C_BUFFER_POSIX_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+#include "c_buffer_wait.h"
+#include "c_buffer_persist.h"
+
+/**
+ * Allocate and initialize a mirrored buffer
+ * The same pages are mapped twice back to back, so all readable data and all free
+ * space are always contiguous. cBufferGetReadPointer never fails on a mirrored buffer.
+ * Note: The size is rounded up to a power of two that is at least one page,
+ *       the actual size is available in inst->size
+ * Note: Only available on Linux, uses memfd_create and mmap
+ * Input: Pointer to buffer instance
+ * Input: Minimum size of the buffer
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if the mapping failed, see errno
+ */
+int32_t cBufferInitMirrored(cBuffer_t *inst, size_t min_size);
+
+/**
+ * Release the mapping of a buffer created with cBufferInitMirrored
+ * Input: Pointer to buffer instance
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferDeinitMirrored(cBuffer_t *inst);
+
+/**
+ * Read from a file descriptor directly into the free space of the buffer
+ * Both free regions are filled by a single readv call and head is moved by the
+ * number of bytes actually read.
+ * Input: Pointer to buffer instance
+ * Input: File descriptor to read from
+ * Returns: cBufferErr_t or num bytes read, 0 at end of file. C_BUFFER_INSUFFICIENT if
+ *          the buffer is full, C_BUFFER_WOULD_BLOCK if a non blocking descriptor has no data
+ *          and C_BUFFER_SYSTEM_ERROR on other errors, see errno
+ */
+cBufferSsize_t cBufferReadFromFd(cBuffer_t *inst, int fd);
+
+/**
+ * Write the buffered data directly to a file descriptor
+ * Both data regions are written by a single writev call and tail is moved by the
+ * number of bytes actually written.
+ * Input: Pointer to buffer instance
+ * Input: File descriptor to write to
+ * Returns: cBufferErr_t or num bytes written, 0 if the buffer is empty. C_BUFFER_WOULD_BLOCK
+ *          if a non blocking descriptor is full and C_BUFFER_SYSTEM_ERROR on other errors, see errno
+ */
+cBufferSsize_t cBufferWriteToFd(cBuffer_t *inst, int fd);
+
+/**
+ * Map a file as the region of a persistent buffer, see c_buffer_persist.h
+ * The file is created if needed and grown to region_size, the data survives
+ * a crash of the process as the pages stay in the page cache.
+ * Note: This does not protect against a power cut. The kernel writes pages back
+ * in any order, so the stored indexes may cover data that never reached storage.
+ * Only the state of the last completed cBufferPersistFlush is safe on storage.
+ * Input: Path of the file
+ * Input: Size of the region
+ * Input: Pointer to store the start of the region
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if the file can't be mapped, see errno
+ */
+int32_t cBufferPersistMapFile(const char *path, size_t region_size, void **region);
+
+/**
+ * Write the region of a mapped file to storage
+ * The data pages are written first, then the pages with the header and the
+ * indexes, so a flush never stores indexes ahead of the data it stores.
+ * Note: The kernel may also write pages back on its own at any time. Only a
+ * flush completed while the producer is stopped leaves a consistent copy on storage.
+ * Input: Start of the region
+ * Input: Size of the region
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if msync failed, see errno
+ */
+int32_t cBufferPersistFlush(void *region, size_t region_size);
+
+/**
+ * Unmap a region mapped with cBufferPersistMapFile, the data stays in the file
+ * Input: Start of the region
+ * Input: Size of the region
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if munmap failed, see errno
+ */
+int32_t cBufferPersistUnmapFile(void *region, size_t region_size);
+
+#ifdef __linux__
+/**
+ * Wait hooks backed by a private futex on the sequence words, see c_buffer_wait.h
+ * Note: Only available on Linux, the hooks are not declared on other POSIX systems
+ */
+extern const cBufferWaitHooks_t cBufferWaitFutexHooks;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_POSIX_H */
@@ -0,0 +1,254 @@
+/**
+ * @file:       c_buffer_record.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Implementation of length prefixed records in a circular buffer
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#include "c_buffer_record.h"
+#include "c_buffer_inline.h"
+#include "c_buffer_stats.h"
+
+// Encode the payload size as a base 128 varint, returns the number of header bytes
+static size_t encodeHeader(size_t data_size, uint8_t header[C_BUFFER_RECORD_MAX_HEADER])
+{
+    size_t header_size = 0;
+
+    while (data_size >= 0x80) {
+        header[header_size++] = (uint8_t)(data_size | 0x80);
+        data_size >>= 7;
+    }
+    header[header_size++] = (uint8_t)data_size;
+
+    return header_size;
+}
+
+// Decode the header of the next record, returns cBufferErr_t or the header size
+static int32_t decodeHeader(cBuffer_t *inst, size_t *data_size)
+{
+    cBufferSsize_t num_bytes = cBufferAvailableForRead(inst);
+    if (num_bytes < C_BUFFER_SUCCESS) {
+        return num_bytes;
+    }
+
+    size_t value = 0;
+    for (int32_t ind = 0; ind < C_BUFFER_RECORD_MAX_HEADER && ind < num_bytes; ind++) {
+        uint8_t byte = cBufferPeekByte(inst, ind);
+        value |= (size_t)(byte & 0x7F) << (7 * ind);
+
+        if ((byte & 0x80) == 0) {
+            // The header is complete, make sure the payload is too
+            if (value > C_BUFFER_MAX_SIZE || value > (size_t)(num_bytes - ind - 1)) {
+                return C_BUFFER_MISMATCH;
+            }
+            *data_size = value;
+            return ind + 1;
+        }
+    }
+
+    return C_BUFFER_MISMATCH;
+}
+
+// Copy data into the free regions starting at an offset
+static void copyToRegions(cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], size_t offset, const uint8_t *data, size_t data_size)
+{
+    for (int ind = 0; ind < C_BUFFER_NUM_REGIONS && data_size > 0; ind++) {
+        if (offset >= regions[ind].size) {
+            offset -= regions[ind].size;
+            continue;
+        }
+
+        size_t chunk = regions[ind].size - offset;
+        if (chunk > data_size) {
+            chunk = data_size;
+        }
+
+        cBufferCopyBytes(regions[ind].data + offset, data, chunk);
+        data      += chunk;
+        data_size -= chunk;
+        offset     = 0;
+    }
+}
+
+size_t cBufferRecordSize(size_t data_size) {
+    uint8_t header[C_BUFFER_RECORD_MAX_HEADER];
+    if (data_size > C_BUFFER_MAX_SIZE) {
+        return 0;
+    }
+
+    return encodeHeader(data_size, header) + data_size;
+}
+
+cBufferSsize_t cBufferPushRecord(cBuffer_t *inst, uint8_t *data, size_t data_size) {
+    if (inst == NULL || (data == NULL && data_size > 0)) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (data_size > C_BUFFER_MAX_SIZE) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    uint8_t header[C_BUFFER_RECORD_MAX_HEADER];
+    size_t header_size = encodeHeader(data_size, header);
+
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+    cBufferSsize_t res = cBufferGetWriteRegions(inst, regions);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    // Refuse the record unless all of it fits
+    if (regions[0].size + regions[1].size < header_size + data_size) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    copyToRegions(regions, 0, header, header_size);
+    copyToRegions(regions, header_size, data, data_size);
+
+    // Publish header and payload together
+    res = cBufferCommitWrite(inst, header_size + data_size);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    return data_size;
+}
+
+cBufferSsize_t cBufferPushRecordOverwrite(cBuffer_t *inst, uint8_t *data, size_t data_size, size_t *dropped) {
+    if (inst == NULL || (data == NULL && data_size > 0) || dropped == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (inst->mode & (C_BUFFER_MODE_SPSC | C_BUFFER_MODE_DMA)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    *dropped = 0;
+
+    size_t record_size = cBufferRecordSize(data_size);
+    if (record_size == 0) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    cBufferSsize_t num_free = cBufferAvailableForWrite(inst);
+    if (record_size > (size_t)num_free + (size_t)cBufferAvailableForRead(inst)) {
+        STATS_INSUFFICIENT(inst);
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    // Drop whole records so no partial record is ever left at the tail
+    while ((size_t)num_free < record_size) {
+        size_t old_size;
+        int32_t header_size = decodeHeader(inst, &old_size);
+        if (header_size < C_BUFFER_SUCCESS) {
+            return header_size;
+        }
+
+        cBufferEmptyRead(inst, header_size + old_size);
+        num_free += header_size + old_size;
+        (*dropped)++;
+    }
+
+    return cBufferPushRecord(inst, data, data_size);
+}
+
+cBufferSsize_t cBufferPeekRecordLen(cBuffer_t *inst) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    size_t data_size;
+    int32_t res = decodeHeader(inst, &data_size);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    return data_size;
+}
+
+cBufferSsize_t cBufferPopRecord(cBuffer_t *inst, uint8_t *data, size_t max_read_size) {
+    if (inst == NULL || data == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    size_t data_size;
+    int32_t header_size = decodeHeader(inst, &data_size);
+    if (header_size < C_BUFFER_SUCCESS) {
+        return header_size;
+    }
+
+    // Leave the record in the buffer if it can't be read
+    if (data_size > max_read_size) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    cBufferSsize_t res = cBufferPeek(inst, header_size, data, data_size);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    res = cBufferEmptyRead(inst, header_size + data_size);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    return data_size;
+}
+
+cBufferSsize_t cBufferPopRecordZeroCopy(cBuffer_t *inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]) {
+    if (inst == NULL || regions == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    size_t data_size;
+    int32_t header_size = decodeHeader(inst, &data_size);
+    if (header_size < C_BUFFER_SUCCESS) {
+        return header_size;
+    }
+
+    cBufferSsize_t res = cBufferEmptyRead(inst, header_size);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    res = cBufferGetReadRegions(inst, regions);
+    if (res < C_BUFFER_SUCCESS) {
+        return res;
+    }
+
+    // Limit the regions to the payload of this record
+    if (regions[0].size >= data_size) {
+        regions[0].size = data_size;
+        regions[1].data = NULL;
+        regions[1].size = 0;
+    } else {
+        regions[1].size = data_size - regions[0].size;
+    }
+
+    if (data_size == 0) {
+        regions[0].data = NULL;
+    }
+
+    return data_size;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file:       c_buffer_record.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Header file for length prefixed records in a circular buffer
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_RECORD_H
+#define C_BUFFER_RECORD_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+// Records are prefixed with their length as a base 128 varint of at most this many bytes
+#ifdef C_BUFFER_LARGE
+#define C_BUFFER_RECORD_MAX_HEADER 9
+#else
+#define C_BUFFER_RECORD_MAX_HEADER 5
+#endif
+
+/**
+ * Get the number of bytes a record occupies in the buffer, including its header
+ * Input: Payload size of the record
+ * Returns: Size of the record in the buffer, 0 if the payload is larger than C_BUFFER_MAX_SIZE
+ */
+size_t cBufferRecordSize(size_t data_size);
+
+/**
+ * Write a length prefixed record at the end of the buffer
+ * The record is published in one step, a reader never sees a partial record
+ * Input: Pointer to buffer instance
+ * Input: Pointer to the payload
+ * Input: Size of the payload, at most C_BUFFER_MAX_SIZE
+ * Returns: cBufferErr_t or payload size, C_BUFFER_INSUFFICIENT if the full record does not fit
+ */
+cBufferSsize_t cBufferPushRecord(cBuffer_t *inst, uint8_t *data, size_t data_size);
+
+/**
+ * Write a length prefixed record, dropping the oldest whole records to make room
+ * Note: Not available in SPSC, MPSC or DMA mode as the tail is moved by the writer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to the payload
+ * Input: Size of the payload, at most C_BUFFER_MAX_SIZE
+ * Input: Pointer to store the number of records dropped
+ * Returns: cBufferErr_t or payload size, C_BUFFER_INSUFFICIENT if the record is larger than the buffer
+ */
+cBufferSsize_t cBufferPushRecordOverwrite(cBuffer_t *inst, uint8_t *data, size_t data_size, size_t *dropped);
+
+/**
+ * Get the payload size of the next record without consuming it
+ * Input: Pointer to buffer instance
+ * Returns: cBufferErr_t or payload size, C_BUFFER_MISMATCH if there is no complete record
+ */
+cBufferSsize_t cBufferPeekRecordLen(cBuffer_t *inst);
+
+/**
+ * Read the next record from the buffer
+ * Input: Pointer to buffer instance
+ * Input: Pointer to data to read the payload into
+ * Input: Maximum payload size that can be read
+ * Returns: cBufferErr_t or payload size, C_BUFFER_MISMATCH if there is no complete record
+ *          and C_BUFFER_INSUFFICIENT if the payload is larger than max_read_size
+ */
+cBufferSsize_t cBufferPopRecord(cBuffer_t *inst, uint8_t *data, size_t max_read_size);
+
+/**
+ * Get the payload of the next record in place as up to two regions
+ * The record header is consumed, use cBufferEmptyRead with the returned size
+ * once the payload has been processed.
+ * Input: Pointer to buffer instance
+ * Input: Array of C_BUFFER_NUM_REGIONS regions, unused regions are set to NULL and 0
+ * Returns: cBufferErr_t or payload size, C_BUFFER_MISMATCH if there is no complete record
+ */
+cBufferSsize_t cBufferPopRecordZeroCopy(cBuffer_t *inst, cBufferRegion_t regions[C_BUFFER_NUM_REGIONS]);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_RECORD_H */
@@ -0,0 +1,76 @@
+/**
+ * @file:       c_buffer_stats.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Usage statistics updates shared by the c_buffer modules
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_STATS_H
+#define C_BUFFER_STATS_H
+
+#include "c_buffer.h"
+#include "c_buffer_inline.h"
+#include <string.h>
+
+/**
+ * Private to the c_buffer sources, every module that rejects or moves data
+ * on its own updates the counters through these so they follow the same rules.
+ * They expand to nothing when C_BUFFER_STATS is not defined.
+ */
+
+#ifdef C_BUFFER_STATS
+// Record a write before the index is moved, wrapped is set if it passes the end of the array
+static inline void statsWrite(cBuffer_t *inst, size_t num_bytes, int wrapped)
+{
+    size_t used = cBufferUsedBytes(inst, cBufferLoadHead(inst), cBufferLoadTail(inst)) + num_bytes;
+
+    inst->stats.bytes_in += num_bytes;
+    if (wrapped) {
+        inst->stats.wrap_count++;
+    }
+    if (used > inst->stats.high_watermark) {
+        inst->stats.high_watermark = used;
+    }
+}
+
+#define STATS_CLEAR(inst) memset(&(inst)->stats, 0, sizeof((inst)->stats))
+#define STATS_WRITE(inst, num_bytes, wrapped) statsWrite((inst), (num_bytes), (wrapped))
+#define STATS_READ(inst, num_bytes) ((inst)->stats.bytes_out += (num_bytes))
+#ifdef C_BUFFER_MPSC
+// Rejections may happen on several producers at once in MPSC mode
+#define STATS_INSUFFICIENT(inst) __atomic_fetch_add(&(inst)->stats.insufficient_count, 1, __ATOMIC_RELAXED)
+#else
+#define STATS_INSUFFICIENT(inst) ((inst)->stats.insufficient_count++)
+#endif
+#define STATS_CONTIGUATE(inst, num_bytes) ((inst)->stats.contiguate_bytes += (num_bytes))
+#else
+#define STATS_CLEAR(inst)
+#define STATS_WRITE(inst, num_bytes, wrapped)
+#define STATS_READ(inst, num_bytes)
+#define STATS_INSUFFICIENT(inst)
+#define STATS_CONTIGUATE(inst, num_bytes)
+#endif
+
+#endif /* C_BUFFER_STATS_H */
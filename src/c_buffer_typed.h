@@ -0,0 +1,274 @@
+/**
+ * @file:       c_buffer_typed.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Circular buffers of whole elements generated for a type
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#ifndef C_BUFFER_TYPED_H
+#define C_BUFFER_TYPED_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "c_buffer.h"
+
+/**
+ * C_BUFFER_DEFINE(name, T) generates a circular buffer that stores elements of
+ * type T. Head and tail count elements, so there is no byte arithmetic and
+ * single elements are moved with plain assignments of T.
+ *
+ * The generated API, e.g. for C_BUFFER_DEFINE(sampleRing, sample_t):
+ *   sampleRing_t, sampleRingRegion_t
+ *   sampleRingInit, sampleRingClear
+ *   sampleRingAvailableForRead, sampleRingAvailableForWrite
+ *   sampleRingPush, sampleRingPop, sampleRingPeek
+ *   sampleRingPushBulk, sampleRingPopBulk
+ *   sampleRingGetReadRegions, sampleRingEmptyRead
+ *   sampleRingGetWriteRegions, sampleRingCommitWrite
+ *
+ * The element count must be a power of two, head and tail are free running
+ * like C_BUFFER_MODE_POW2 and every element can be used.
+ * Note: The generated buffers are not thread safe, use them from one context.
+ */
+
+// Copy whole elements, the NO_MEMCPY loop lets the compiler move them as T
+#ifdef NO_MEMCPY
+#define C_BUFFER_TYPED_COPY(dst, src, count) \
+    for (size_t copy_ind = 0; copy_ind < (count); copy_ind++) { (dst)[copy_ind] = (src)[copy_ind]; }
+#else
+#define C_BUFFER_TYPED_COPY(dst, src, count) memcpy((dst), (src), (count) * sizeof(*(dst)))
+#endif
+
+#define C_BUFFER_DEFINE(name, T) \
+typedef struct { \
+    T *data; \
+    size_t size; \
+    cBufferIndex_t head; \
+    cBufferIndex_t tail; \
+} name##_t; \
+\
+/* A contiguous span of elements in the array */ \
+typedef struct { \
+    T *data; \
+    size_t size; \
+} name##Region_t; \
+\
+/* Returns: cBufferErr_t, C_BUFFER_MISMATCH if num_elements is not a power of two */ \
+static inline int32_t name##Init(name##_t *inst, T *buffer, size_t num_elements) \
+{ \
+    if (inst == NULL || buffer == NULL || num_elements == 0) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if ((num_elements & (num_elements - 1)) != 0 || num_elements > C_BUFFER_MAX_SIZE) { \
+        return C_BUFFER_MISMATCH; \
+    } \
+    inst->data = buffer; \
+    inst->size = num_elements; \
+    inst->head = 0; \
+    inst->tail = 0; \
+    return C_BUFFER_SUCCESS; \
+} \
+\
+static inline int32_t name##Clear(name##_t *inst) \
+{ \
+    if (inst == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    inst->head = 0; \
+    inst->tail = 0; \
+    return C_BUFFER_SUCCESS; \
+} \
+\
+/* Returns: cBufferErr_t or the number of stored elements */ \
+static inline cBufferSsize_t name##AvailableForRead(const name##_t *inst) \
+{ \
+    if (inst == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    return (size_t)(cBufferIndex_t)(inst->head - inst->tail); \
+} \
+\
+/* Returns: cBufferErr_t or the number of free elements */ \
+static inline cBufferSsize_t name##AvailableForWrite(const name##_t *inst) \
+{ \
+    if (inst == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    return inst->size - (size_t)(cBufferIndex_t)(inst->head - inst->tail); \
+} \
+\
+/* Returns: cBufferErr_t, C_BUFFER_INSUFFICIENT if the buffer is full */ \
+static inline int32_t name##Push(name##_t *inst, const T *element) \
+{ \
+    if (inst == NULL || element == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if ((cBufferIndex_t)(inst->head - inst->tail) == inst->size) { \
+        return C_BUFFER_INSUFFICIENT; \
+    } \
+    inst->data[inst->head & (inst->size - 1)] = *element; \
+    inst->head++; \
+    return C_BUFFER_SUCCESS; \
+} \
+\
+/* Returns: cBufferErr_t, C_BUFFER_MISMATCH if the buffer is empty */ \
+static inline int32_t name##Pop(name##_t *inst, T *element) \
+{ \
+    if (inst == NULL || element == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (inst->head == inst->tail) { \
+        return C_BUFFER_MISMATCH; \
+    } \
+    *element = inst->data[inst->tail & (inst->size - 1)]; \
+    inst->tail++; \
+    return C_BUFFER_SUCCESS; \
+} \
+\
+/* Read the element at an offset from the tail without consuming it */ \
+/* Returns: cBufferErr_t, C_BUFFER_MISMATCH if offset is past the stored elements */ \
+static inline int32_t name##Peek(const name##_t *inst, size_t offset, T *element) \
+{ \
+    if (inst == NULL || element == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (offset >= (size_t)(cBufferIndex_t)(inst->head - inst->tail)) { \
+        return C_BUFFER_MISMATCH; \
+    } \
+    *element = inst->data[(inst->tail + offset) & (inst->size - 1)]; \
+    return C_BUFFER_SUCCESS; \
+} \
+\
+/* All or nothing */ \
+/* Returns: cBufferErr_t or count, C_BUFFER_INSUFFICIENT if not all elements fit */ \
+static inline cBufferSsize_t name##PushBulk(name##_t *inst, const T *elements, size_t count) \
+{ \
+    if (inst == NULL || elements == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (count > inst->size - (size_t)(cBufferIndex_t)(inst->head - inst->tail)) { \
+        return C_BUFFER_INSUFFICIENT; \
+    } \
+    size_t pos = inst->head & (inst->size - 1); \
+    size_t first = count < inst->size - pos ? count : inst->size - pos; \
+    C_BUFFER_TYPED_COPY(inst->data + pos, elements, first); \
+    C_BUFFER_TYPED_COPY(inst->data, elements + first, count - first); \
+    inst->head += (cBufferIndex_t)count; \
+    return count; \
+} \
+\
+/* All or nothing */ \
+/* Returns: cBufferErr_t or count, C_BUFFER_MISMATCH if fewer elements are stored */ \
+static inline cBufferSsize_t name##PopBulk(name##_t *inst, T *elements, size_t count) \
+{ \
+    if (inst == NULL || elements == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (count > (size_t)(cBufferIndex_t)(inst->head - inst->tail)) { \
+        return C_BUFFER_MISMATCH; \
+    } \
+    size_t pos = inst->tail & (inst->size - 1); \
+    size_t first = count < inst->size - pos ? count : inst->size - pos; \
+    C_BUFFER_TYPED_COPY(elements, inst->data + pos, first); \
+    C_BUFFER_TYPED_COPY(elements + first, inst->data, count - first); \
+    inst->tail += (cBufferIndex_t)count; \
+    return count; \
+} \
+\
+/* Stored elements in place, the second region holds the elements after the wrap */ \
+/* Returns: cBufferErr_t or number of regions holding data */ \
+static inline int32_t name##GetReadRegions(const name##_t *inst, name##Region_t regions[C_BUFFER_NUM_REGIONS]) \
+{ \
+    if (inst == NULL || regions == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    size_t used = (size_t)(cBufferIndex_t)(inst->head - inst->tail); \
+    size_t pos = inst->tail & (inst->size - 1); \
+    regions[0].data = inst->data + pos; \
+    regions[0].size = used < inst->size - pos ? used : inst->size - pos; \
+    regions[1].data = inst->data; \
+    regions[1].size = used - regions[0].size; \
+    if (regions[0].size == 0) { \
+        regions[0].data = NULL; \
+    } \
+    if (regions[1].size == 0) { \
+        regions[1].data = NULL; \
+    } \
+    return (regions[0].size > 0) + (regions[1].size > 0); \
+} \
+\
+/* Returns: cBufferErr_t or count, C_BUFFER_MISMATCH if fewer elements are stored */ \
+static inline cBufferSsize_t name##EmptyRead(name##_t *inst, size_t count) \
+{ \
+    if (inst == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (count > (size_t)(cBufferIndex_t)(inst->head - inst->tail)) { \
+        return C_BUFFER_MISMATCH; \
+    } \
+    inst->tail += (cBufferIndex_t)count; \
+    return count; \
+} \
+\
+/* Free elements in place, fill them and publish with CommitWrite */ \
+/* Returns: cBufferErr_t or number of regions holding free space */ \
+static inline int32_t name##GetWriteRegions(const name##_t *inst, name##Region_t regions[C_BUFFER_NUM_REGIONS]) \
+{ \
+    if (inst == NULL || regions == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    size_t num_free = inst->size - (size_t)(cBufferIndex_t)(inst->head - inst->tail); \
+    size_t pos = inst->head & (inst->size - 1); \
+    regions[0].data = inst->data + pos; \
+    regions[0].size = num_free < inst->size - pos ? num_free : inst->size - pos; \
+    regions[1].data = inst->data; \
+    regions[1].size = num_free - regions[0].size; \
+    if (regions[0].size == 0) { \
+        regions[0].data = NULL; \
+    } \
+    if (regions[1].size == 0) { \
+        regions[1].data = NULL; \
+    } \
+    return (regions[0].size > 0) + (regions[1].size > 0); \
+} \
+\
+/* Returns: cBufferErr_t or count, C_BUFFER_INSUFFICIENT if more than the free elements */ \
+static inline cBufferSsize_t name##CommitWrite(name##_t *inst, size_t count) \
+{ \
+    if (inst == NULL) { \
+        return C_BUFFER_NULL_ERROR; \
+    } \
+    if (count > inst->size - (size_t)(cBufferIndex_t)(inst->head - inst->tail)) { \
+        return C_BUFFER_INSUFFICIENT; \
+    } \
+    inst->head += (cBufferIndex_t)count; \
+    return count; \
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_TYPED_H */
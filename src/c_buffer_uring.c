@@ -0,0 +1,316 @@
+/**
+ * @file:       c_buffer_uring.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      io_uring backend that reads and writes buffer regions in place
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "c_buffer_uring.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// The low bits of the instance pointer in user_data tell the request apart
+#define URING_WRITE_BIT  ((uint64_t)1)
+#define URING_SECOND_BIT ((uint64_t)2)
+#define URING_FLAG_MASK  (URING_WRITE_BIT | URING_SECOND_BIT)
+
+// Registered buffers are limited to 1 GiB each by the kernel
+#define URING_MAX_BUFFER_SIZE ((size_t)1 << 30)
+
+int32_t cBufferUringInit(cBufferUring_t *ring, uint32_t entries) {
+    struct io_uring_params params;
+
+    if (ring == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (entries == 0) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    ring->ring_fd      = fd;
+    ring->sq_entries   = params.sq_entries;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Newer kernels map both rings with one call
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) {
+            ring->sq_ring_size = ring->cq_ring_size;
+        }
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        close(fd);
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+            close(fd);
+            return C_BUFFER_SYSTEM_ERROR;
+        }
+    }
+
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cq_ring != ring->sq_ring) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        munmap(ring->sq_ring, ring->sq_ring_size);
+        close(fd);
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    uint8_t *sq = (uint8_t *)ring->sq_ring;
+    uint8_t *cq = (uint8_t *)ring->cq_ring;
+    ring->sq_head  = (uint32_t *)(sq + params.sq_off.head);
+    ring->sq_tail  = (uint32_t *)(sq + params.sq_off.tail);
+    ring->sq_mask  = (uint32_t *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (uint32_t *)(sq + params.sq_off.array);
+    ring->cq_head  = (uint32_t *)(cq + params.cq_off.head);
+    ring->cq_tail  = (uint32_t *)(cq + params.cq_off.tail);
+    ring->cq_mask  = (uint32_t *)(cq + params.cq_off.ring_mask);
+    ring->cqes     = cq + params.cq_off.cqes;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferUringDeinit(cBufferUring_t *ring) {
+    if (ring == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->ring_fd);
+    ring->ring_fd = -1;
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferUringRegister(cBufferUring_t *ring, cBuffer_t *const *buffers, size_t num_buffers) {
+    if (ring == NULL || buffers == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    if (num_buffers == 0 || num_buffers > UINT16_MAX + 1) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    // Thousands of buffers don't fit on the stack
+    struct iovec *iov = calloc(num_buffers, sizeof(*iov));
+    if (iov == NULL) {
+        return C_BUFFER_SYSTEM_ERROR;
+    }
+
+    int32_t res = C_BUFFER_SUCCESS;
+    for (size_t ind = 0; ind < num_buffers; ind++) {
+        if (buffers[ind] == NULL) {
+            res = C_BUFFER_NULL_ERROR;
+            break;
+        }
+
+        // The regions of a mirrored buffer may run into the second mapping
+        size_t size = buffers[ind]->size;
+        if (buffers[ind]->mode & C_BUFFER_MODE_MIRRORED) {
+            size *= 2;
+        }
+
+        if (size > URING_MAX_BUFFER_SIZE) {
+            res = C_BUFFER_MISMATCH;
+            break;
+        }
+
+        iov[ind].iov_base = buffers[ind]->data;
+        iov[ind].iov_len  = size;
+    }
+
+    if (res == C_BUFFER_SUCCESS &&
+        syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_BUFFERS, iov, (unsigned)num_buffers) < 0) {
+        res = C_BUFFER_SYSTEM_ERROR;
+    }
+
+    free(iov);
+
+    return res;
+}
+
+// Queue one request per region, linked so the second only runs after the first completed in full
+static int32_t queueRegions(cBufferUring_t *ring, cBuffer_t *inst, uint16_t buf_index, int fd,
+                            const cBufferRegion_t regions[C_BUFFER_NUM_REGIONS], int32_t num_regions,
+                            uint8_t opcode, uint64_t write_bit)
+{
+    uint32_t tail = *ring->sq_tail;
+    uint32_t head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    if (ring->sq_entries - (tail - head) < (uint32_t)num_regions) {
+        return C_BUFFER_WOULD_BLOCK;
+    }
+
+    for (int32_t ind = 0; ind < num_regions; ind++) {
+        uint32_t slot = tail & *ring->sq_mask;
+        struct io_uring_sqe *sqe = (struct io_uring_sqe *)ring->sqes + slot;
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode    = opcode;
+        sqe->fd        = fd;
+        sqe->addr      = (uint64_t)(uintptr_t)regions[ind].data;
+        sqe->len       = (uint32_t)regions[ind].size;
+        sqe->off       = (uint64_t)-1;
+        sqe->buf_index = buf_index;
+        sqe->user_data = (uint64_t)(uintptr_t)inst | write_bit | (ind > 0 ? URING_SECOND_BIT : 0);
+        if (ind + 1 < num_regions) {
+            sqe->flags = IOSQE_IO_LINK;
+        }
+
+        ring->sq_array[slot] = slot;
+        tail++;
+    }
+
+    // Publish the entries to the kernel
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    ring->to_submit += (uint32_t)num_regions;
+
+    return num_regions;
+}
+
+int32_t cBufferUringQueueRead(cBufferUring_t *ring, cBuffer_t *inst, uint16_t buf_index, int fd) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+    if (ring == NULL || inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t num_regions = cBufferGetWriteRegions(inst, regions);
+    if (num_regions < C_BUFFER_SUCCESS) {
+        return num_regions;
+    }
+
+    if (num_regions == 0) {
+        return C_BUFFER_INSUFFICIENT;
+    }
+
+    return queueRegions(ring, inst, buf_index, fd, regions, num_regions, IORING_OP_READ_FIXED, 0);
+}
+
+int32_t cBufferUringQueueWrite(cBufferUring_t *ring, cBuffer_t *inst, uint16_t buf_index, int fd) {
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+    if (ring == NULL || inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    int32_t num_regions = cBufferGetReadRegions(inst, regions);
+    if (num_regions <= 0) {
+        return num_regions;
+    }
+
+    return queueRegions(ring, inst, buf_index, fd, regions, num_regions, IORING_OP_WRITE_FIXED, URING_WRITE_BIT);
+}
+
+int32_t cBufferUringSubmit(cBufferUring_t *ring, uint32_t wait_nr) {
+    if (ring == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    long res = syscall(__NR_io_uring_enter, ring->ring_fd, ring->to_submit, wait_nr, flags, NULL, 0);
+    if (res < 0) {
+        return errno == EAGAIN || errno == EBUSY ? C_BUFFER_WOULD_BLOCK : C_BUFFER_SYSTEM_ERROR;
+    }
+
+    ring->to_submit -= (uint32_t)res;
+
+    return (int32_t)res;
+}
+
+int32_t cBufferUringComplete(cBufferUring_t *ring, cBufferUringCb_t cb, void *ctx) {
+    if (ring == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    uint32_t head = *ring->cq_head;
+    uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    int32_t  num_completed = 0;
+
+    for (; head != tail; head++) {
+        struct io_uring_cqe *cqe = (struct io_uring_cqe *)ring->cqes + (head & *ring->cq_mask);
+        cBuffer_t *inst = (cBuffer_t *)(uintptr_t)(cqe->user_data & ~URING_FLAG_MASK);
+        int is_write    = (cqe->user_data & URING_WRITE_BIT) != 0;
+        int32_t res     = cqe->res;
+
+        // The second half of a pair is cancelled when the first one came up short
+        if (res == -ECANCELED && (cqe->user_data & URING_SECOND_BIT)) {
+            continue;
+        }
+
+        if (res > 0) {
+            if (is_write) {
+                cBufferEmptyRead(inst, (size_t)res);
+            } else {
+                cBufferCommitWrite(inst, (size_t)res);
+            }
+        }
+
+        if (cb != NULL) {
+            cb(ctx, inst, is_write, res);
+        }
+        num_completed++;
+    }
+
+    // Give the entries back to the kernel
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+    return num_completed;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file:       c_buffer_uring.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      io_uring backend that reads and writes buffer regions in place
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_URING_H
+#define C_BUFFER_URING_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+/**
+ * An io_uring instance moves data between file descriptors and many buffers
+ * with one system call per batch. The data arrays are registered as fixed
+ * buffers, a read fills both free regions of a buffer and a write sends both
+ * data regions, each as two linked fixed buffer requests. Head and tail are
+ * only moved when the completions are handled by cBufferUringComplete.
+ * Note: Only available on Linux, uses the raw io_uring system calls
+ * Note: Keep at most one read and one write in flight per buffer and don't
+ *       touch the side of the buffer that has a request in flight. Use SPSC or
+ *       power of two buffers as the empty buffer resets of the other modes move
+ *       the indexes under the kernel.
+ */
+
+// Called for every completion after the buffer indexes have been moved
+// res is the number of bytes moved, 0 at end of file, or a negative errno
+typedef void (*cBufferUringCb_t)(void *ctx, cBuffer_t *inst, int is_write, int32_t res);
+
+typedef struct {
+    int       ring_fd;
+    uint32_t  sq_entries;
+    uint32_t *sq_head;
+    uint32_t *sq_tail;
+    uint32_t *sq_mask;
+    uint32_t *sq_array;
+    void     *sqes;
+    uint32_t *cq_head;
+    uint32_t *cq_tail;
+    uint32_t *cq_mask;
+    void     *cqes;
+    void     *sq_ring;
+    size_t    sq_ring_size;
+    void     *cq_ring;
+    size_t    cq_ring_size;
+    size_t    sqes_size;
+    uint32_t  to_submit;
+} cBufferUring_t;
+
+/**
+ * Set up an io_uring instance
+ * Input: Pointer to uring instance
+ * Input: Number of submission entries, every queued read or write takes up to two
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if the kernel refused, see errno
+ */
+int32_t cBufferUringInit(cBufferUring_t *ring, uint32_t entries);
+
+/**
+ * Release the io_uring instance, requests still in flight are cancelled by the kernel
+ * Input: Pointer to uring instance
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferUringDeinit(cBufferUring_t *ring);
+
+/**
+ * Register the data arrays of the buffers as fixed buffers
+ * The position of a buffer in the array is the buf_index used when queueing.
+ * Input: Pointer to uring instance
+ * Input: Array of buffer instances
+ * Input: Number of buffers
+ * Returns: cBufferErr_t, C_BUFFER_SYSTEM_ERROR if the kernel refused, see errno
+ */
+int32_t cBufferUringRegister(cBufferUring_t *ring, cBuffer_t *const *buffers, size_t num_buffers);
+
+/**
+ * Queue a read from a file descriptor into the free space of the buffer
+ * Input: Pointer to uring instance
+ * Input: Pointer to buffer instance
+ * Input: Index of the buffer given to cBufferUringRegister
+ * Input: File descriptor to read from
+ * Returns: cBufferErr_t or number of requests queued, C_BUFFER_INSUFFICIENT if
+ *          the buffer is full and C_BUFFER_WOULD_BLOCK if the submission queue is full
+ */
+int32_t cBufferUringQueueRead(cBufferUring_t *ring, cBuffer_t *inst, uint16_t buf_index, int fd);
+
+/**
+ * Queue a write of the buffered data to a file descriptor
+ * Input: Pointer to uring instance
+ * Input: Pointer to buffer instance
+ * Input: Index of the buffer given to cBufferUringRegister
+ * Input: File descriptor to write to
+ * Returns: cBufferErr_t or number of requests queued, 0 if the buffer is empty and
+ *          C_BUFFER_WOULD_BLOCK if the submission queue is full
+ */
+int32_t cBufferUringQueueWrite(cBufferUring_t *ring, cBuffer_t *inst, uint16_t buf_index, int fd);
+
+/**
+ * Submit all queued requests in one system call
+ * Input: Pointer to uring instance
+ * Input: Number of completions to wait for, 0 to return at once
+ * Returns: cBufferErr_t or number of requests submitted, C_BUFFER_SYSTEM_ERROR on failure, see errno
+ */
+int32_t cBufferUringSubmit(cBufferUring_t *ring, uint32_t wait_nr);
+
+/**
+ * Handle all available completions, commits what was read and consumes what was written
+ * Input: Pointer to uring instance
+ * Input: Callback for every completion, may be NULL
+ * Input: Context passed to the callback
+ * Returns: cBufferErr_t or number of completions handled
+ */
+int32_t cBufferUringComplete(cBufferUring_t *ring, cBufferUringCb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_URING_H */
@@ -0,0 +1,143 @@
+/**
+ * @file:       c_buffer_wait.c
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Blocking waits on a circular buffer through pluggable sleep and wake hooks
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#include "c_buffer_wait.h"
+#include "c_buffer_inline.h"
+
+// Publish what the caller needs and sleep on seq until the other side wakes it
+static cBufferSsize_t waitFor(cBufferWait_t *inst, size_t *want, uint32_t *seq,
+                              cBufferSsize_t (*available)(cBuffer_t *), size_t min_bytes, int32_t timeout_ms)
+{
+    if (min_bytes == 0 || min_bytes > cBufferCapacity(inst->cb)) {
+        return C_BUFFER_MISMATCH;
+    }
+
+    while (1) {
+        uint32_t expected = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(want, min_bytes, __ATOMIC_RELAXED);
+
+        // Pairs with the fence in notify, either this load sees the new index
+        // or the notifying side sees want and bumps seq before waking
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        cBufferSsize_t num_bytes = available(inst->cb);
+        if (num_bytes < C_BUFFER_SUCCESS || (size_t)num_bytes >= min_bytes) {
+            __atomic_store_n(want, 0, __ATOMIC_RELAXED);
+            return num_bytes;
+        }
+
+        if (timeout_ms == 0) {
+            __atomic_store_n(want, 0, __ATOMIC_RELAXED);
+            return C_BUFFER_WOULD_BLOCK;
+        }
+
+        int32_t res = inst->hooks->wait(inst->hooks->ctx, seq, expected, timeout_ms);
+        if (res < C_BUFFER_SUCCESS) {
+            __atomic_store_n(want, 0, __ATOMIC_RELAXED);
+            return res;
+        }
+    }
+}
+
+// Wake the sleeping side once the available bytes reach what it asked for
+static int32_t notify(cBufferWait_t *inst, size_t *want, uint32_t *seq, cBufferSsize_t (*available)(cBuffer_t *))
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // The common case, nobody waits
+    size_t wanted = __atomic_load_n(want, __ATOMIC_RELAXED);
+    if (wanted == 0) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    cBufferSsize_t num_bytes = available(inst->cb);
+    if (num_bytes < C_BUFFER_SUCCESS) {
+        return num_bytes;
+    }
+
+    if ((size_t)num_bytes < wanted) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    // Several MPSC producers may notify at once, only one of them wakes
+    if (!__atomic_compare_exchange_n(want, &wanted, 0, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return C_BUFFER_SUCCESS;
+    }
+
+    __atomic_fetch_add(seq, 1, __ATOMIC_RELEASE);
+    inst->hooks->wake(inst->hooks->ctx, seq);
+
+    return C_BUFFER_SUCCESS;
+}
+
+int32_t cBufferWaitInit(cBufferWait_t *inst, cBuffer_t *cb, const cBufferWaitHooks_t *hooks) {
+    if (inst == NULL || cb == NULL || hooks == NULL || hooks->wait == NULL || hooks->wake == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    inst->cb         = cb;
+    inst->hooks      = hooks;
+    inst->read_want  = 0;
+    inst->write_want = 0;
+    inst->read_seq   = 0;
+    inst->write_seq  = 0;
+
+    return C_BUFFER_SUCCESS;
+}
+
+cBufferSsize_t cBufferWaitReadable(cBufferWait_t *inst, size_t min_bytes, int32_t timeout_ms) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return waitFor(inst, &inst->read_want, &inst->read_seq, cBufferAvailableForRead, min_bytes, timeout_ms);
+}
+
+cBufferSsize_t cBufferWaitWritable(cBufferWait_t *inst, size_t min_bytes, int32_t timeout_ms) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return waitFor(inst, &inst->write_want, &inst->write_seq, cBufferAvailableForWrite, min_bytes, timeout_ms);
+}
+
+int32_t cBufferNotifyReadable(cBufferWait_t *inst) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return notify(inst, &inst->read_want, &inst->read_seq, cBufferAvailableForRead);
+}
+
+int32_t cBufferNotifyWritable(cBufferWait_t *inst) {
+    if (inst == NULL) {
+        return C_BUFFER_NULL_ERROR;
+    }
+
+    return notify(inst, &inst->write_want, &inst->write_seq, cBufferAvailableForWrite);
+}
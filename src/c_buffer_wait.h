@@ -0,0 +1,121 @@
+/**
+ * @file:       c_buffer_wait.h
+ * @author:     Lucas Wennerholm <lucas.wennerholm@gmail.com>
+ * @brief:      Blocking waits on a circular buffer through pluggable sleep and wake hooks
+ *
+ * @license: MIT License
+ *
+ * Copyright (c) 2024 Lucas Wennerholm
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#ifndef C_BUFFER_WAIT_H
+#define C_BUFFER_WAIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "c_buffer.h"
+
+/**
+ * A wait instance lets one consumer sleep until enough data is readable and one
+ * producer sleep until enough space is free. The sleeping side publishes how
+ * much it needs, and the other side only wakes it once that threshold is
+ * crossed, so a busy stream costs one fence and one load per notify call and
+ * no syscall at all while nobody waits.
+ *
+ * The producer calls cBufferNotifyReadable after appending, typically once per
+ * batch, and the consumer calls cBufferNotifyWritable after reading.
+ *
+ * Sleeping is done through hooks, see cBufferWaitFutexHooks in c_buffer_posix.h
+ * for Linux. On an RTOS the hooks can ignore the word and use a binary
+ * semaphore per direction, wait takes it with a timeout and wake gives it.
+ */
+
+typedef struct {
+    // Sleep while *word == expected, a negative timeout waits forever
+    // Returns: C_BUFFER_SUCCESS when woken or if *word changed, C_BUFFER_WOULD_BLOCK on timeout
+    int32_t (*wait)(void *ctx, uint32_t *word, uint32_t expected, int32_t timeout_ms);
+    // Wake the side sleeping on word
+    void (*wake)(void *ctx, uint32_t *word);
+    void *ctx;
+} cBufferWaitHooks_t;
+
+typedef struct {
+    cBuffer_t *cb;
+    const cBufferWaitHooks_t *hooks;
+    // Bytes the sleeping side needs, 0 when nobody waits
+    size_t   read_want;
+    size_t   write_want;
+    // Bumped on every wake, this is the word the hooks sleep on
+    uint32_t read_seq;
+    uint32_t write_seq;
+} cBufferWait_t;
+
+/**
+ * Initialize a wait instance for a buffer
+ * Note: Use an SPSC or MPSC buffer when the two sides run in different threads
+ * Input: Pointer to wait instance
+ * Input: Pointer to an initialized buffer
+ * Input: Pointer to the sleep and wake hooks, must stay valid
+ * Returns: cBufferErr_t
+ */
+int32_t cBufferWaitInit(cBufferWait_t *inst, cBuffer_t *cb, const cBufferWaitHooks_t *hooks);
+
+/**
+ * Wait until at least min_bytes can be read
+ * Note: Only one consumer may wait at a time, the timeout restarts after a spurious wake
+ * Input: Pointer to wait instance
+ * Input: Number of bytes to wait for, at least 1 and at most the capacity
+ * Input: Timeout in ms, 0 to poll and negative to wait forever
+ * Returns: cBufferErr_t or num bytes readable, C_BUFFER_WOULD_BLOCK on timeout
+ */
+cBufferSsize_t cBufferWaitReadable(cBufferWait_t *inst, size_t min_bytes, int32_t timeout_ms);
+
+/**
+ * Wait until at least min_bytes can be written
+ * Note: Only one producer may wait at a time, the timeout restarts after a spurious wake
+ * Input: Pointer to wait instance
+ * Input: Number of bytes to wait for, at least 1 and at most the capacity
+ * Input: Timeout in ms, 0 to poll and negative to wait forever
+ * Returns: cBufferErr_t or num bytes free, C_BUFFER_WOULD_BLOCK on timeout
+ */
+cBufferSsize_t cBufferWaitWritable(cBufferWait_t *inst, size_t min_bytes, int32_t timeout_ms);
+
+/**
+ * Wake the consumer if it waits for no more than the readable data, call after appending
+ * Input: Pointer to wait instance
+ * Returns: cBufferErr_t, C_BUFFER_SUCCESS also when nobody was woken
+ */
+int32_t cBufferNotifyReadable(cBufferWait_t *inst);
+
+/**
+ * Wake the producer if it waits for no more than the free space, call after reading
+ * Input: Pointer to wait instance
+ * Returns: cBufferErr_t, C_BUFFER_SUCCESS also when nobody was woken
+ */
+int32_t cBufferNotifyWritable(cBufferWait_t *inst);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* C_BUFFER_WAIT_H */
@@ -1,10 +1,113 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
 #include "c_buffer.h"
+#include "c_buffer_inline.h"
 
 #define MAIN_BUFFER_SIZE 16
 #define SMALL_BUFFER_SIZE 10
+#define SPSC_TEST_BYTES 200000
+#define MPSC_TEST_PRODUCERS 3
+#define MPSC_TEST_WORDS 20000
+
+static void *spscProducer(void *arg) {
+    cBuffer_t *cb = (cBuffer_t *)arg;
+    uint8_t chunk[7];
+    uint32_t sent = 0;
+
+    // Mix single bytes and chunks to exercise both producer paths
+    while (sent < SPSC_TEST_BYTES) {
+        if (sent % 2) {
+            if (cBufferAppendByte(cb, (uint8_t)sent) == 1) {
+                sent++;
+            } else {
+                sched_yield();
+            }
+        } else {
+            size_t len = sizeof(chunk);
+            if (SPSC_TEST_BYTES - sent < len) {
+                len = SPSC_TEST_BYTES - sent;
+            }
+            for (size_t i = 0; i < len; i++) {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            if (cBufferAppend(cb, chunk, len) == (int32_t)len) {
+                sent += len;
+            } else {
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+#ifdef C_BUFFER_MPSC
+typedef struct {
+    cBuffer_t *cb;
+    uint32_t   id;
+} mpscProducerArg_t;
+
+static void *mpscProducer(void *arg) {
+    mpscProducerArg_t *producer = (mpscProducerArg_t *)arg;
+    uint32_t seq = 0;
+
+    // Each word holds the producer id and a sequence number, single words and
+    // pairs are mixed so both the word and the bulk paths race each other
+    while (seq < MPSC_TEST_WORDS) {
+        uint32_t word = (producer->id << 24) | seq;
+        int32_t res;
+        if (seq % 3 == 0 && seq + 1 < MPSC_TEST_WORDS) {
+            uint8_t pair[8];
+            for (int i = 0; i < 2; i++) {
+                uint32_t w = word + i;
+                pair[4 * i]     = (uint8_t)(w >> 24);
+                pair[4 * i + 1] = (uint8_t)(w >> 16);
+                pair[4 * i + 2] = (uint8_t)(w >> 8);
+                pair[4 * i + 3] = (uint8_t)w;
+            }
+            res = cBufferAppend(producer->cb, pair, sizeof(pair));
+            if (res == (int32_t)sizeof(pair)) {
+                seq += 2;
+            }
+        } else {
+            res = cBufferAppendUint32(producer->cb, word);
+            if (res == (int32_t)sizeof(word)) {
+                seq++;
+            }
+        }
+
+        if (res == C_BUFFER_INSUFFICIENT) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+#ifdef C_BUFFER_DMA
+// Stands in for a DMA channel writing circularly into the buffer array
+typedef struct {
+    uint8_t *array;
+    size_t   size;
+    uint32_t pos;
+} fakeDma_t;
+
+static void fakeDmaWrite(fakeDma_t *dma, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        dma->array[dma->pos] = data[i];
+        dma->pos = (dma->pos + 1) % dma->size;
+    }
+}
+
+static uint32_t fakeDmaPos(void *ctx) {
+    return ((fakeDma_t *)ctx)->pos;
+}
+#endif
 
 int main(void) {
     int32_t ret;
@@ -158,6 +261,851 @@ int main(void) {
         printf("Test 5: ReadAll after contiguate returned \"%s\".\n", smallOut);
     }
 
+    /********* Test 6: Power of two mode *********/
+    {
+        cBuffer_t cb_pow2;
+        uint8_t pow2Buffer[MAIN_BUFFER_SIZE];
+        ret = cBufferInitPow2(&cb_pow2, pow2Buffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = cBufferInitPow2(&cb_pow2, pow2Buffer, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        printf("Test 6: Initialized power of two buffer (%d bytes).\n", MAIN_BUFFER_SIZE);
+
+        // The full array is available
+        available = cBufferAvailableForWrite(&cb_pow2);
+        assert(available == MAIN_BUFFER_SIZE);
+
+        const char *data1 = "0123456789ABCDEF";  // 16 bytes.
+        ret = cBufferAppend(&cb_pow2, (uint8_t*)data1, strlen(data1));
+        assert(ret == MAIN_BUFFER_SIZE);
+        assert(cBufferFull(&cb_pow2) == 1);
+        ret = cBufferAppendByte(&cb_pow2, 'X');
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        // Read 12 bytes and append 8 to force a wrap
+        ret = cBufferReadBytes(&cb_pow2, out, 12);
+        assert(ret == 12);
+        const char *data2 = "GHIJKLMN";
+        ret = cBufferAppend(&cb_pow2, (uint8_t*)data2, strlen(data2));
+        assert(ret == (int32_t)strlen(data2));
+        assert(cBufferIsContigous(&cb_pow2) == C_BUFFER_WRAPED);
+
+        ret = cBufferPrependUint16(&cb_pow2, 0x5859);
+        assert(ret == 2);
+        available = cBufferAvailableForRead(&cb_pow2);
+        assert(available == 14);
+
+        ret = cBufferContiguate(&cb_pow2);
+        assert(ret == C_BUFFER_SUCCESS);
+        uint8_t *read_ptr = cBufferGetReadPointer(&cb_pow2);
+        assert(read_ptr != NULL);
+        assert(memcmp(read_ptr, "XYCDEFGHIJKLMN", 14) == 0);
+
+        ret = cBufferReadAll(&cb_pow2, out, MAIN_BUFFER_SIZE);
+        assert(ret == 14);
+        out[ret] = '\0';
+        printf("Test 6: ReadAll after wrap returned \"%s\".\n", out);
+        assert(strcmp((char*)out, "XYCDEFGHIJKLMN") == 0);
+    }
+
+    /********* Test 7: SPSC with a concurrent producer *********/
+    {
+        cBuffer_t cb_spsc;
+        uint8_t spscBuffer[MAIN_BUFFER_SIZE];
+        ret = cBufferInitSpsc(&cb_spsc, spscBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = cBufferInitSpsc(&cb_spsc, spscBuffer, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        pthread_t producer;
+        ret = pthread_create(&producer, NULL, spscProducer, &cb_spsc);
+        assert(ret == 0);
+
+        uint32_t received = 0;
+        uint8_t chunk[5];
+        while (received < SPSC_TEST_BYTES) {
+            available = cBufferAvailableForRead(&cb_spsc);
+            if (available == 0) {
+                sched_yield();
+                continue;
+            }
+
+            if (received % 3) {
+                byte = cBufferReadByte(&cb_spsc);
+                assert(byte == (uint8_t)received);
+                received++;
+            } else {
+                size_t len = (size_t)available < sizeof(chunk) ? (size_t)available : sizeof(chunk);
+                ret = cBufferReadBytes(&cb_spsc, chunk, len);
+                assert(ret == (int32_t)len);
+                for (size_t i = 0; i < len; i++) {
+                    assert(chunk[i] == (uint8_t)(received + i));
+                }
+                received += len;
+            }
+        }
+
+        pthread_join(producer, NULL);
+        assert(cBufferEmpty(&cb_spsc) == 1);
+        printf("Test 7: SPSC transferred %d bytes without locking.\n", SPSC_TEST_BYTES);
+    }
+
+    /********* Test 8: Read regions *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferGetReadRegions(&cb_small, regions);
+        assert(ret == 0);
+        assert(regions[0].size == 0 && regions[1].size == 0);
+
+        const char *data1 = "ABCDEFG";
+        ret = cBufferAppend(&cb_small, (uint8_t*)data1, strlen(data1));
+        assert(ret == (int32_t)strlen(data1));
+
+        ret = cBufferGetReadRegions(&cb_small, regions);
+        assert(ret == 1);
+        assert(regions[0].size == 7 && memcmp(regions[0].data, "ABCDEFG", 7) == 0);
+
+        // Consume in place and wrap the data
+        ret = cBufferEmptyRead(&cb_small, 5);
+        assert(ret == 5);
+        const char *data2 = "XYZW";
+        ret = cBufferAppend(&cb_small, (uint8_t*)data2, strlen(data2));
+        assert(ret == (int32_t)strlen(data2));
+
+        ret = cBufferGetReadRegions(&cb_small, regions);
+        assert(ret == 2);
+        assert(regions[0].size == 5 && memcmp(regions[0].data, "FGXYZ", 5) == 0);
+        assert(regions[1].size == 1 && memcmp(regions[1].data, "W", 1) == 0);
+
+        ret = cBufferEmptyRead(&cb_small, regions[0].size + regions[1].size);
+        assert(ret == 6);
+        assert(cBufferEmpty(&cb_small) == 1);
+        printf("Test 8: Read regions covered the wrapped data.\n");
+    }
+
+    /********* Test 9: Write reservation *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+        uint8_t *write_ptr;
+        size_t write_len;
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // An empty buffer offers all of its capacity
+        ret = cBufferReserveWrite(&cb_small, 1, &write_ptr, &write_len);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(write_ptr == smallBuffer && write_len == SMALL_BUFFER_SIZE - C_BUFFER_ARRAY_OVERHEAD);
+
+        memcpy(write_ptr, "ABCDEF", 6);
+        ret = cBufferCommitWrite(&cb_small, 6);
+        assert(ret == 6);
+        ret = cBufferEmptyRead(&cb_small, 4);
+        assert(ret == 4);
+
+        // Four bytes to the end of the array and three after the wrap
+        ret = cBufferReserveWrite(&cb_small, 5, &write_ptr, &write_len);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferReserveWrite(&cb_small, 4, &write_ptr, &write_len);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(write_ptr == &smallBuffer[6] && write_len == 4);
+
+        ret = cBufferGetWriteRegions(&cb_small, regions);
+        assert(ret == 2);
+        assert(regions[0].data == &smallBuffer[6] && regions[0].size == 4);
+        assert(regions[1].data == smallBuffer && regions[1].size == 3);
+        memcpy(regions[0].data, "GHIJ", 4);
+        memcpy(regions[1].data, "KLM", 3);
+
+        // Committing more than the free space is refused
+        ret = cBufferCommitWrite(&cb_small, 8);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferEmptyWrite(&cb_small, 8);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferCommitWrite(&cb_small, 7);
+        assert(ret == 7);
+        assert(cBufferFull(&cb_small) == 1);
+
+        ret = cBufferReadAll(&cb_small, smallOut, SMALL_BUFFER_SIZE);
+        assert(ret == 9);
+        smallOut[ret] = '\0';
+        assert(strcmp((char*)smallOut, "EFGHIJKLM") == 0);
+        printf("Test 9: Reserve and commit returned \"%s\".\n", smallOut);
+    }
+
+    /********* Test 10: Contiguate strategies *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        uint8_t scratch[4];
+        uint8_t *read_ptr;
+
+        // Short first part that fits in the free space in front of the second part
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFGH", 8);
+        assert(ret == 8);
+        ret = cBufferEmptyRead(&cb_small, 6);
+        assert(ret == 6);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"123", 3);
+        assert(ret == 3);
+        assert(cBufferIsContigous(&cb_small) == C_BUFFER_WRAPED);
+        ret = cBufferContiguate(&cb_small);
+        assert(ret == C_BUFFER_SUCCESS);
+        read_ptr = cBufferGetReadPointer(&cb_small);
+        assert(read_ptr != NULL && memcmp(read_ptr, "GH123", 5) == 0);
+
+        // Large first part, the first part is moved down in front of the tail
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFGH", 8);
+        assert(ret == 8);
+        ret = cBufferEmptyRead(&cb_small, 4);
+        assert(ret == 4);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"123", 3);
+        assert(ret == 3);
+        ret = cBufferContiguate(&cb_small);
+        assert(ret == C_BUFFER_SUCCESS);
+        read_ptr = cBufferGetReadPointer(&cb_small);
+        assert(read_ptr == &smallBuffer[3] && memcmp(read_ptr, "EFGH123", 7) == 0);
+
+        // A full buffer with a short first part parks the first part in the scratch buffer
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFGH", 8);
+        assert(ret == 8);
+        ret = cBufferEmptyRead(&cb_small, 6);
+        assert(ret == 6);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"1234567", 7);
+        assert(ret == 7);
+        assert(cBufferFull(&cb_small) == 1);
+        ret = cBufferContiguateScratch(&cb_small, scratch, sizeof(scratch));
+        assert(ret == C_BUFFER_SUCCESS);
+        read_ptr = cBufferGetReadPointer(&cb_small);
+        assert(read_ptr == smallBuffer && memcmp(read_ptr, "GH1234567", 9) == 0);
+
+        // A full buffer must use the scratch buffer or rotate in place
+        for (int i = 0; i < 2; i++) {
+            ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+            assert(ret == C_BUFFER_SUCCESS);
+            ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFGH", 8);
+            assert(ret == 8);
+            ret = cBufferEmptyRead(&cb_small, 5);
+            assert(ret == 5);
+            ret = cBufferAppend(&cb_small, (uint8_t*)"123456", 6);
+            assert(ret == 6);
+            assert(cBufferFull(&cb_small) == 1);
+
+            if (i == 0) {
+                ret = cBufferContiguateScratch(&cb_small, scratch, sizeof(scratch));
+            } else {
+                ret = cBufferContiguate(&cb_small);
+            }
+            assert(ret == C_BUFFER_SUCCESS);
+            read_ptr = cBufferGetReadPointer(&cb_small);
+            assert(read_ptr != NULL && memcmp(read_ptr, "FGH123456", 9) == 0);
+        }
+        printf("Test 10: Contiguate with free space, scratch and in place rotation.\n");
+    }
+
+    /********* Test 11: Peek *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        uint8_t header[4];
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Place a frame across the wrap
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFG", 7);
+        assert(ret == 7);
+        ret = cBufferEmptyRead(&cb_small, 7);
+        assert(ret == 7);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"\x02\x05HELLO", 7);
+        assert(ret == 7);
+
+        assert(cBufferPeekByte(&cb_small, 0) == 0x02);
+        assert(cBufferPeekByte(&cb_small, 1) == 0x05);
+        assert(cBufferPeekByte(&cb_small, 7) == 0);
+        ret = cBufferPeek(&cb_small, 1, header, 4);
+        assert(ret == 4);
+        assert(memcmp(header, "\x05HEL", 4) == 0);
+        ret = cBufferPeek(&cb_small, 4, header, 4);
+        assert(ret == C_BUFFER_MISMATCH);
+
+        // Nothing was consumed
+        available = cBufferAvailableForRead(&cb_small);
+        assert(available == 7);
+        ret = cBufferReadBytes(&cb_small, smallOut, 7);
+        assert(ret == 7);
+        assert(memcmp(smallOut, "\x02\x05HELLO", 7) == 0);
+        printf("Test 11: Peek read a header across the wrap.\n");
+    }
+
+    /********* Test 12: Fixed width integers *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        uint16_t val16;
+        uint32_t val32;
+        uint64_t val64;
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferAppendUint32(&cb_small, 0x01020304);
+        assert(ret == 4);
+        ret = cBufferAppendUint32Le(&cb_small, 0x01020304);
+        assert(ret == 4);
+        assert(memcmp(smallBuffer, "\x01\x02\x03\x04\x04\x03\x02\x01", 8) == 0);
+        ret = cBufferAppendUint16(&cb_small, 0x0506);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        ret = cBufferReadUint32(&cb_small, &val32);
+        assert(ret == 4 && val32 == 0x01020304);
+        ret = cBufferReadUint32Le(&cb_small, &val32);
+        assert(ret == 4 && val32 == 0x01020304);
+
+        // A 64 bit value split by the wrap
+        ret = cBufferAppendUint64(&cb_small, 0x1122334455667788ULL);
+        assert(ret == 8);
+        assert(cBufferIsContigous(&cb_small) == C_BUFFER_WRAPED);
+        ret = cBufferPeek(&cb_small, 0, smallOut, 8);
+        assert(ret == 8);
+        assert(memcmp(smallOut, "\x11\x22\x33\x44\x55\x66\x77\x88", 8) == 0);
+        ret = cBufferReadUint64(&cb_small, &val64);
+        assert(ret == 8 && val64 == 0x1122334455667788ULL);
+
+        ret = cBufferReadUint16(&cb_small, &val16);
+        assert(ret == C_BUFFER_MISMATCH);
+
+        ret = cBufferAppendUint64Le(&cb_small, 0x1122334455667788ULL);
+        assert(ret == 8);
+        ret = cBufferReadUint64Le(&cb_small, &val64);
+        assert(ret == 8 && val64 == 0x1122334455667788ULL);
+
+        ret = cBufferAppendUint16Le(&cb_small, 0xA1B2);
+        assert(ret == 2);
+        ret = cBufferPrependUint16Le(&cb_small, 0xC1D2);
+        assert(ret == 2);
+        ret = cBufferPrependUint32Le(&cb_small, 0xE1E2E3E4);
+        assert(ret == 4);
+        ret = cBufferPrependUint64(&cb_small, 0x0102);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferReadUint32Le(&cb_small, &val32);
+        assert(ret == 4 && val32 == 0xE1E2E3E4);
+        ret = cBufferReadUint16Le(&cb_small, &val16);
+        assert(ret == 2 && val16 == 0xC1D2);
+        ret = cBufferReadUint16(&cb_small, &val16);
+        assert(ret == 2 && val16 == 0xB2A1);
+
+        ret = cBufferPrependUint64Le(&cb_small, 0x0102030405060708ULL);
+        assert(ret == 8);
+        ret = cBufferReadUint64(&cb_small, &val64);
+        assert(ret == 8 && val64 == 0x0807060504030201ULL);
+        printf("Test 12: Fixed width integers in both byte orders.\n");
+    }
+
+    /********* Test 13: Find *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        size_t scan = 0;
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEF", 6);
+        assert(ret == 6);
+        ret = cBufferEmptyRead(&cb_small, 6);
+        assert(ret == 6);
+
+        // A line that is split by the wrap, arriving in pieces
+        ret = cBufferAppend(&cb_small, (uint8_t*)"OK\r", 3);
+        assert(ret == 3);
+        ret = cBufferScan(&cb_small, (uint8_t*)"\r\n", 2, &scan);
+        assert(ret == C_BUFFER_NOT_FOUND);
+        assert(scan == 2);
+
+        ret = cBufferAppend(&cb_small, (uint8_t*)"\nAT", 3);
+        assert(ret == 3);
+        assert(cBufferIsContigous(&cb_small) == C_BUFFER_WRAPED);
+        ret = cBufferScan(&cb_small, (uint8_t*)"\r\n", 2, &scan);
+        assert(ret == 2);
+
+        assert(cBufferFind(&cb_small, '\n', 0) == 3);
+        assert(cBufferFind(&cb_small, 'T', 0) == 5);
+        assert(cBufferFind(&cb_small, 'A', 5) == C_BUFFER_NOT_FOUND);
+        assert(cBufferFindPattern(&cb_small, (uint8_t*)"\nAT", 3, 0) == 3);
+        assert(cBufferFindPattern(&cb_small, (uint8_t*)"ATX", 3, 0) == C_BUFFER_NOT_FOUND);
+        printf("Test 13: Found the line ending across the wrap.\n");
+    }
+
+#ifdef C_BUFFER_STATS
+    /********* Test 14: Statistics *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        cBufferStats_t stats;
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEFG", 7);
+        assert(ret == 7);
+        ret = cBufferEmptyRead(&cb_small, 5);
+        assert(ret == 5);
+
+        // Crosses the end of the array
+        ret = cBufferAppend(&cb_small, (uint8_t*)"HIJKL", 5);
+        assert(ret == 5);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"MNO", 3);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferContiguate(&cb_small);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferReadBytes(&cb_small, smallOut, 7);
+        assert(ret == 7);
+
+        ret = cBufferGetStats(&cb_small, &stats);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(stats.high_watermark == 7);
+        assert(stats.insufficient_count == 1);
+        assert(stats.wrap_count == 1);
+        assert(stats.contiguate_bytes == 7);
+        assert(stats.bytes_in == 12);
+        assert(stats.bytes_out == 12);
+
+        ret = cBufferResetStats(&cb_small);
+        assert(ret == C_BUFFER_SUCCESS);
+        cBufferGetStats(&cb_small, &stats);
+        assert(stats.high_watermark == 0);
+        assert(stats.bytes_in == 0 && stats.wrap_count == 0);
+        printf("Test 14: Statistics tracked the watermark and the wrap.\n");
+    }
+#endif
+
+    /********* Test 15: Unchecked fast path *********/
+    {
+        cBuffer_t cb_pow2;
+        uint8_t pow2Buffer[MAIN_BUFFER_SIZE];
+        ret = cBufferInitPow2(&cb_pow2, pow2Buffer, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Move the indexes so that the byte loop crosses the wrap
+        ret = cBufferEmptyWrite(&cb_pow2, 12);
+        assert(ret == 12);
+        ret = cBufferEmptyRead(&cb_pow2, 12);
+        assert(ret == 12);
+
+        size_t space = cBufferAvailableForWriteUnchecked(&cb_pow2);
+        assert(space == MAIN_BUFFER_SIZE);
+        for (size_t i = 0; i < space; i++) {
+            cBufferAppendByteUnchecked(&cb_pow2, (uint8_t)i);
+        }
+        assert(cBufferFullUnchecked(&cb_pow2));
+        assert(cBufferAvailableForRead(&cb_pow2) == MAIN_BUFFER_SIZE);
+
+        size_t num = cBufferAvailableForReadUnchecked(&cb_pow2);
+        for (size_t i = 0; i < num; i++) {
+            assert(cBufferReadByteUnchecked(&cb_pow2) == (uint8_t)i);
+        }
+        assert(cBufferEmptyUnchecked(&cb_pow2));
+        printf("Test 15: Unchecked byte loop across the wrap.\n");
+    }
+
+    /********* Test 16: SPSC space checks *********/
+    {
+        cBuffer_t cb_spsc;
+        uint8_t spscBuffer[MAIN_BUFFER_SIZE];
+        ret = cBufferInitSpsc(&cb_spsc, spscBuffer, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+#ifdef C_BUFFER_CACHE_LINE_SIZE
+        assert(offsetof(cBuffer_t, tail) - offsetof(cBuffer_t, head) >= C_BUFFER_CACHE_LINE_SIZE);
+#endif
+
+        ret = cBufferAppend(&cb_spsc, (uint8_t*)"0123456789ABCDEF", MAIN_BUFFER_SIZE);
+        assert(ret == MAIN_BUFFER_SIZE);
+        ret = cBufferAppendByte(&cb_spsc, 'X');
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        // The producer must see the space freed by the consumer
+        ret = cBufferReadBytes(&cb_spsc, out, 4);
+        assert(ret == 4);
+        ret = cBufferAppend(&cb_spsc, (uint8_t*)"GHIJ", 4);
+        assert(ret == 4);
+
+        // Space taken back by a prepend must not be handed out again
+        ret = cBufferReadBytes(&cb_spsc, out, 2);
+        assert(ret == 2);
+        ret = cBufferPrepend(&cb_spsc, (uint8_t*)"45", 2);
+        assert(ret == 2);
+        ret = cBufferAppendByte(&cb_spsc, 'X');
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        // The consumer must see data added after it found the buffer empty
+        ret = cBufferReadBytes(&cb_spsc, out, MAIN_BUFFER_SIZE);
+        assert(ret == MAIN_BUFFER_SIZE);
+        assert(memcmp(out, "456789ABCDEFGHIJ", MAIN_BUFFER_SIZE) == 0);
+        assert(cBufferEmptyRead(&cb_spsc, 1) == C_BUFFER_MISMATCH);
+        ret = cBufferAppendUint16(&cb_spsc, 0x1234);
+        assert(ret == 2);
+        assert(cBufferPeekByte(&cb_spsc, 1) == 0x34);
+        printf("Test 16: SPSC space checks follow both indexes.\n");
+    }
+
+#ifdef C_BUFFER_MPSC
+    /********* Test 17: MPSC producers *********/
+    {
+        cBuffer_t cb_mpsc;
+        uint8_t mpscBuffer[256];
+        pthread_t threads[MPSC_TEST_PRODUCERS];
+        mpscProducerArg_t args[MPSC_TEST_PRODUCERS];
+        uint32_t expected[MPSC_TEST_PRODUCERS] = {0};
+        uint32_t word;
+        uint8_t *ptr;
+        size_t len;
+
+        ret = cBufferInitMpsc(&cb_mpsc, mpscBuffer, sizeof(mpscBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Zero copy writes can't be ordered between producers
+        assert(cBufferReserveWrite(&cb_mpsc, 1, &ptr, &len) == C_BUFFER_MISMATCH);
+        assert(cBufferCommitWrite(&cb_mpsc, 1) == C_BUFFER_MISMATCH);
+
+        for (uint32_t i = 0; i < MPSC_TEST_PRODUCERS; i++) {
+            args[i].cb = &cb_mpsc;
+            args[i].id = i;
+            ret = pthread_create(&threads[i], NULL, mpscProducer, &args[i]);
+            assert(ret == 0);
+        }
+
+        // Every word must be complete and each producer's words in order
+        for (uint32_t received = 0; received < MPSC_TEST_PRODUCERS * MPSC_TEST_WORDS;) {
+            ret = cBufferReadUint32(&cb_mpsc, &word);
+            if (ret == C_BUFFER_MISMATCH) {
+                sched_yield();
+                continue;
+            }
+            assert(ret == sizeof(word));
+            uint32_t id = word >> 24;
+            assert(id < MPSC_TEST_PRODUCERS);
+            assert((word & 0xFFFFFF) == expected[id]);
+            expected[id]++;
+            received++;
+        }
+
+        for (uint32_t i = 0; i < MPSC_TEST_PRODUCERS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        assert(cBufferEmpty(&cb_mpsc));
+        printf("Test 17: MPSC producers published complete words in order.\n");
+    }
+#endif
+
+    /********* Test 18: Aligned arrays and DMA head *********/
+    {
+        cBuffer_t cb_dma;
+        static uint8_t dmaBuffer[2 * MAIN_BUFFER_SIZE] __attribute__((aligned(2 * MAIN_BUFFER_SIZE)));
+
+        ret = cBufferInitAligned(&cb_dma, dmaBuffer + 1, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = cBufferInitAligned(&cb_dma, dmaBuffer, MAIN_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+#ifdef C_BUFFER_DMA
+        fakeDma_t dma = {dmaBuffer, MAIN_BUFFER_SIZE, 5};
+        ret = cBufferSetHeadCallback(&cb_dma, fakeDmaPos, &dma);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(cBufferEmpty(&cb_dma));
+
+        // The CPU can only consume
+        assert(cBufferAppendByte(&cb_dma, 'X') == C_BUFFER_MISMATCH);
+        assert(cBufferPrepend(&cb_dma, (uint8_t*)"X", 1) == C_BUFFER_MISMATCH);
+        assert(cBufferContiguate(&cb_dma) == C_BUFFER_MISMATCH);
+
+        // Data written by the hardware across the end of the array
+        fakeDmaWrite(&dma, (uint8_t*)"0123456789AB", 12);
+        assert(cBufferAvailableForRead(&cb_dma) == 12);
+        assert(cBufferIsContigous(&cb_dma) == C_BUFFER_WRAPED);
+        ret = cBufferReadBytes(&cb_dma, out, 10);
+        assert(ret == 10);
+        assert(memcmp(out, "0123456789", 10) == 0);
+
+        fakeDmaWrite(&dma, (uint8_t*)"CDEFGHIJKLMNO", 13);
+        ret = cBufferReadAll(&cb_dma, out, MAIN_BUFFER_SIZE);
+        assert(ret == 15);
+        assert(memcmp(out, "ABCDEFGHIJKLMNO", 15) == 0);
+
+        fakeDmaWrite(&dma, (uint8_t*)"PQR", 3);
+        assert(cBufferReadByte(&cb_dma) == 'P');
+        ret = cBufferClear(&cb_dma);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(cBufferEmpty(&cb_dma));
+#endif
+        printf("Test 18: Aligned init and hardware owned head.\n");
+    }
+
+    /********* Test 19: Transfer between buffers *********/
+    {
+        cBuffer_t cb_src;
+        cBuffer_t cb_dst;
+        uint8_t srcBuffer[SMALL_BUFFER_SIZE];
+        uint8_t dstBuffer[SMALL_BUFFER_SIZE];
+        ret = cBufferInit(&cb_src, srcBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferInit(&cb_dst, dstBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Wrap both buffers at different positions
+        ret = cBufferEmptyWrite(&cb_src, 6);
+        assert(ret == 6);
+        ret = cBufferEmptyRead(&cb_src, 6);
+        assert(ret == 6);
+        ret = cBufferAppend(&cb_src, (uint8_t*)"ABCDEFGH", 8);
+        assert(ret == 8);
+        ret = cBufferEmptyWrite(&cb_dst, 8);
+        assert(ret == 8);
+        ret = cBufferEmptyRead(&cb_dst, 7);
+        assert(ret == 7);
+
+        ret = cBufferTransfer(&cb_dst, &cb_src, 3);
+        assert(ret == 3);
+        ret = cBufferTransfer(&cb_dst, &cb_src, SMALL_BUFFER_SIZE);
+        assert(ret == 5);
+        assert(cBufferEmpty(&cb_src));
+        assert(cBufferIsContigous(&cb_dst) == C_BUFFER_WRAPED);
+
+        ret = cBufferEmptyRead(&cb_dst, 1);
+        assert(ret == 1);
+        ret = cBufferReadBytes(&cb_dst, smallOut, 8);
+        assert(ret == 8);
+        assert(memcmp(smallOut, "ABCDEFGH", 8) == 0);
+
+        // Limited by the space in dst
+        ret = cBufferAppend(&cb_src, (uint8_t*)"123456789", 9);
+        assert(ret == 9);
+        ret = cBufferAppend(&cb_dst, (uint8_t*)"xxxxx", 5);
+        assert(ret == 5);
+        ret = cBufferTransfer(&cb_dst, &cb_src, SMALL_BUFFER_SIZE);
+        assert(ret == 4);
+        assert(cBufferAvailableForRead(&cb_src) == 5);
+        assert(cBufferTransfer(&cb_dst, &cb_dst, 1) == C_BUFFER_MISMATCH);
+        printf("Test 19: Transferred between two wrapped buffers.\n");
+    }
+
+    /********* Test 20: Index limits *********/
+    {
+        cBuffer_t cb_limit;
+        uint8_t limitBuffer[8];
+
+        // Sizes whose byte counts don't fit in cBufferSsize_t are refused
+#if SIZE_MAX > C_BUFFER_MAX_SIZE
+        ret = cBufferInit(&cb_limit, limitBuffer, (size_t)C_BUFFER_MAX_SIZE + 1);
+        assert(ret == C_BUFFER_MISMATCH);
+#endif
+
+        // Free running indexes must survive the wrap of cBufferIndex_t
+        ret = cBufferInitPow2(&cb_limit, limitBuffer, sizeof(limitBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        cb_limit.head = (cBufferIndex_t)-3;
+        cb_limit.tail = (cBufferIndex_t)-3;
+        ret = cBufferAppend(&cb_limit, (uint8_t*)"ABCDEF", 6);
+        assert(ret == 6);
+        assert(cb_limit.head == 3);
+        assert(cBufferAvailableForRead(&cb_limit) == 6);
+        ret = cBufferReadBytes(&cb_limit, out, 6);
+        assert(ret == 6);
+        assert(memcmp(out, "ABCDEF", 6) == 0);
+        printf("Test 20: Index type wrap with %zu byte indexes.\n", sizeof(cBufferIndex_t));
+    }
+
+    /********* Test 21: Overwrite the oldest data *********/
+    {
+        cBuffer_t cb_log;
+        uint8_t logBuffer[8];
+        size_t dropped;
+
+        ret = cBufferInitPow2(&cb_log, logBuffer, sizeof(logBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppendOverwrite(&cb_log, (uint8_t*)"ABCDEF", 6, &dropped);
+        assert(ret == 6 && dropped == 0);
+
+        // Takes the two free bytes and three of the oldest, across the wrap
+        ret = cBufferAppendOverwrite(&cb_log, (uint8_t*)"GHIJK", 5, &dropped);
+        assert(ret == 5 && dropped == 3);
+        assert(cBufferFull(&cb_log) == 1);
+        ret = cBufferReadBytes(&cb_log, out, 8);
+        assert(ret == 8);
+        assert(memcmp(out, "DEFGHIJK", 8) == 0);
+
+        ret = cBufferAppendOverwrite(&cb_log, out, 9, &dropped);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        ret = cBufferInitSpsc(&cb_log, logBuffer, sizeof(logBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppendOverwrite(&cb_log, (uint8_t*)"AB", 2, &dropped);
+        assert(ret == C_BUFFER_MISMATCH);
+        printf("Test 21: Overwrite kept the newest bytes.\n");
+    }
+
+    /********* Test 22: Headroom for prepends *********/
+    {
+        cBuffer_t cb_frame;
+        uint8_t frameBuffer[32];
+
+        ret = cBufferInitWithHeadroom(&cb_frame, frameBuffer, sizeof(frameBuffer), 31);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = cBufferInitWithHeadroom(&cb_frame, frameBuffer, sizeof(frameBuffer), 8);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // The payload goes in first, the headers are added in front of it
+        ret = cBufferAppend(&cb_frame, (uint8_t*)"PAYLOAD", 7);
+        assert(ret == 7);
+        assert(cBufferReserveHeadroom(&cb_frame, 4) == C_BUFFER_MISMATCH);
+        ret = cBufferPrependUint16(&cb_frame, 0x1234);
+        assert(ret == 2);
+        ret = cBufferPrependByte(&cb_frame, 0xAA);
+        assert(ret == 1);
+
+        // The whole frame is contiguous right after the remaining headroom
+        assert(cBufferIsContigous(&cb_frame) == C_BUFFER_SUCCESS);
+        assert(cBufferGetReadPointer(&cb_frame) == frameBuffer + 5);
+        assert(memcmp(frameBuffer + 5, "\xAA\x12\x34PAYLOAD", 10) == 0);
+
+        // Every reset of the empty buffer goes back to the headroom
+        ret = cBufferReadAll(&cb_frame, out, sizeof(out));
+        assert(ret == 10);
+        ret = cBufferPrepend(&cb_frame, (uint8_t*)"HDR", 3);
+        assert(ret == 3);
+        assert(cBufferGetReadPointer(&cb_frame) == frameBuffer + 5);
+        ret = cBufferClear(&cb_frame);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppendByte(&cb_frame, 'X');
+        assert(ret == 1);
+        assert(cBufferGetReadPointer(&cb_frame) == frameBuffer + 8);
+
+        // A buffer drained with ReadBytes also restarts at the headroom on the next append
+        ret = cBufferClear(&cb_frame);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppend(&cb_frame, out, 20);
+        assert(ret == 20);
+        ret = cBufferPrependUint16(&cb_frame, 0x1234);
+        assert(ret == 2);
+        ret = cBufferReadBytes(&cb_frame, out, 22);
+        assert(ret == 22);
+        ret = cBufferAppend(&cb_frame, (uint8_t*)"0123456789", 10);
+        assert(ret == 10);
+        ret = cBufferPrependUint16(&cb_frame, 0x1234);
+        assert(ret == 2);
+        assert(cBufferGetReadPointer(&cb_frame) == frameBuffer + 6);
+
+        ret = cBufferInitSpsc(&cb_frame, frameBuffer, sizeof(frameBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(cBufferReserveHeadroom(&cb_frame, 8) == C_BUFFER_MISMATCH);
+        printf("Test 22: Headers were prepended in front of the payload.\n");
+    }
+
+    /********* Test 23: Scatter gather copies *********/
+    {
+        cBuffer_t cb_vec;
+        uint8_t vecBuffer[16];
+        uint8_t header[3], payload[6], trailer[2];
+
+        ret = cBufferInitPow2(&cb_vec, vecBuffer, sizeof(vecBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Move the head close to the end so the frame wraps
+        ret = cBufferAppend(&cb_vec, (uint8_t*)"0123456789AB", 12);
+        assert(ret == 12);
+        ret = cBufferReadBytes(&cb_vec, out, 12);
+        assert(ret == 12);
+
+        cBufferRegion_t frame[3] = {
+            {(uint8_t*)"HDR", 3},
+            {(uint8_t*)"PAYLOD", 6},
+            {(uint8_t*)"CS", 2},
+        };
+        ret = cBufferAppendv(&cb_vec, frame, 3);
+        assert(ret == 11);
+
+        // A list that does not fit as a whole writes nothing
+        ret = cBufferAppendv(&cb_vec, frame, 2);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        assert(cBufferAvailableForRead(&cb_vec) == 11);
+
+        cBufferRegion_t parts[3] = {
+            {header, sizeof(header)},
+            {payload, sizeof(payload)},
+            {trailer, sizeof(trailer)},
+        };
+        ret = cBufferReadv(&cb_vec, parts, 3);
+        assert(ret == 11);
+        assert(memcmp(header, "HDR", 3) == 0);
+        assert(memcmp(payload, "PAYLOD", 6) == 0);
+        assert(memcmp(trailer, "CS", 2) == 0);
+
+        // Reading more than is stored consumes nothing
+        ret = cBufferAppend(&cb_vec, (uint8_t*)"HDRPAY", 6);
+        assert(ret == 6);
+        ret = cBufferReadv(&cb_vec, parts, 2);
+        assert(ret == C_BUFFER_MISMATCH);
+        assert(cBufferAvailableForRead(&cb_vec) == 6);
+
+#ifdef C_BUFFER_MPSC
+        // MPSC producers reserve the whole frame at once
+        ret = cBufferInitMpsc(&cb_vec, vecBuffer, sizeof(vecBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppendv(&cb_vec, frame, 3);
+        assert(ret == 11);
+        ret = cBufferReadBytes(&cb_vec, out, 11);
+        assert(ret == 11);
+        assert(memcmp(out, "HDRPAYLODCS", 11) == 0);
+#endif
+
+        cBufferRegion_t bad[1] = {{NULL, 1}};
+        assert(cBufferAppendv(&cb_vec, bad, 1) == C_BUFFER_NULL_ERROR);
+        assert(cBufferReadv(&cb_vec, bad, 1) == C_BUFFER_NULL_ERROR);
+        printf("Test 23: Pieces were written and read as one frame.\n");
+    }
+
+    /********* Test 24: Copies at every alignment *********/
+    {
+        cBuffer_t cb_align;
+        uint8_t alignBuffer[100];
+        uint8_t pattern[80];
+        uint8_t back[80 + 8];
+
+        for (size_t ind = 0; ind < sizeof(pattern); ind++) {
+            pattern[ind] = (uint8_t)(ind * 7 + 1);
+        }
+
+        ret = cBufferInit(&cb_align, alignBuffer, sizeof(alignBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // One byte is always stored so the buffer is never reset and the head walks around
+        ret = cBufferAppendByte(&cb_align, 0);
+        assert(ret == 1);
+
+        // Many head positions, source offsets and destination offsets, with and without a wrap
+        for (size_t size = 1; size <= 64; size += 7) {
+            for (size_t offset = 0; offset < 8; offset++) {
+                ret = cBufferAppend(&cb_align, pattern + offset, size);
+                assert(ret == (int32_t)size);
+                cBufferReadByte(&cb_align);
+                ret = cBufferReadBytes(&cb_align, back + (7 - offset), size);
+                assert(ret == (int32_t)size);
+                assert(memcmp(back + (7 - offset), pattern + offset, size) == 0);
+                ret = cBufferAppendByte(&cb_align, 0);
+                assert(ret == 1);
+            }
+        }
+        printf("Test 24: Copies matched at every alignment.\n");
+    }
+
     printf("=== All tests passed! ===\n");
     return 0;
 }
\ No newline at end of file
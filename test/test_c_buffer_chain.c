@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer.h"
+#include "c_buffer_chain.h"
+
+#define BLOCK_SIZE 16
+#define NUM_BLOCKS 4
+
+int main(void) {
+    int32_t ret;
+    uint8_t out[BLOCK_SIZE * NUM_BLOCKS];
+    uint8_t data[BLOCK_SIZE * NUM_BLOCKS + 1];
+    static uint8_t memory[2048];
+    cBufferPool_t pool;
+    cBufferChain_t chain;
+    cBufferChain_t other;
+
+    printf("=== Circular Buffer Chain Test Suite ===\n");
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    /********* Test 1: Grow and shrink *********/
+    ret = cBufferPoolInit(&pool, memory, 10, BLOCK_SIZE);
+    assert(ret == C_BUFFER_INSUFFICIENT);
+    ret = cBufferPoolInit(&pool, memory, sizeof(memory), 12);
+    assert(ret == C_BUFFER_MISMATCH);
+    ret = cBufferPoolInit(&pool, memory, cBufferPoolMemorySize(BLOCK_SIZE, NUM_BLOCKS), BLOCK_SIZE);
+    assert(ret == NUM_BLOCKS);
+
+    ret = cBufferChainInit(&chain, &pool);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferChainInit(&other, &pool);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(cBufferPoolAvailable(&pool) == NUM_BLOCKS);
+
+    // Spread over three blocks
+    ret = cBufferChainAppend(&chain, data, 40);
+    assert(ret == 40);
+    assert(cBufferPoolAvailable(&pool) == 1);
+    assert(cBufferChainAvailableForRead(&chain) == 40);
+    assert(cBufferChainAvailableForWrite(&chain) == 8 + BLOCK_SIZE);
+
+    // All or nothing
+    ret = cBufferChainAppend(&other, data, BLOCK_SIZE + 1);
+    assert(ret == C_BUFFER_INSUFFICIENT);
+    assert(cBufferPoolAvailable(&pool) == 1);
+
+    // Blocks go back to the pool as soon as they are read empty
+    ret = cBufferChainReadBytes(&chain, out, 20);
+    assert(ret == 20);
+    assert(memcmp(out, data, 20) == 0);
+    assert(cBufferPoolAvailable(&pool) == 2);
+
+    ret = cBufferChainAppend(&other, data, BLOCK_SIZE + 1);
+    assert(ret == BLOCK_SIZE + 1);
+    assert(cBufferPoolAvailable(&pool) == 0);
+
+    ret = cBufferChainReadBytes(&chain, out, 21);
+    assert(ret == C_BUFFER_MISMATCH);
+    ret = cBufferChainReadBytes(&chain, out, 20);
+    assert(ret == 20);
+    assert(memcmp(out, data + 20, 20) == 0);
+    assert(cBufferPoolAvailable(&pool) == 2);
+    printf("Test 1: Chain grew to 3 blocks and gave them back.\n");
+
+    /********* Test 2: Regions and reserve *********/
+    cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+    uint8_t *ptr;
+    size_t len;
+
+    ret = cBufferChainGetReadRegions(&chain, regions);
+    assert(ret == 0);
+
+    ret = cBufferChainReserveWrite(&chain, BLOCK_SIZE + 1, &ptr, &len);
+    assert(ret == C_BUFFER_INSUFFICIENT);
+    ret = cBufferChainReserveWrite(&chain, 10, &ptr, &len);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(len == BLOCK_SIZE);
+    memcpy(ptr, "0123456789", 10);
+    ret = cBufferChainCommitWrite(&chain, 10);
+    assert(ret == 10);
+
+    // Not enough contiguous space left, a new block is started
+    ret = cBufferChainReserveWrite(&chain, 8, &ptr, &len);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(cBufferPoolAvailable(&pool) == 0);
+    memcpy(ptr, "ABCDEFGH", 8);
+    ret = cBufferChainCommitWrite(&chain, 8);
+    assert(ret == 8);
+
+    ret = cBufferChainGetReadRegions(&chain, regions);
+    assert(ret == 1);
+    assert(regions[0].size == 10);
+    assert(memcmp(regions[0].data, "0123456789", 10) == 0);
+    ret = cBufferChainEmptyRead(&chain, 12);
+    assert(ret == 12);
+
+    ret = cBufferChainGetReadRegions(&chain, regions);
+    assert(ret == 1);
+    assert(regions[0].size == 6);
+    assert(memcmp(regions[0].data, "CDEFGH", 6) == 0);
+    printf("Test 2: Reserve started a new block when the last one was short.\n");
+
+    /********* Test 3: Clear *********/
+    ret = cBufferChainClear(&chain);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferChainClear(&other);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(cBufferPoolAvailable(&pool) == NUM_BLOCKS);
+    assert(cBufferChainAvailableForRead(&chain) == 0);
+
+    ret = cBufferChainAppend(&chain, data, BLOCK_SIZE * NUM_BLOCKS);
+    assert(ret == BLOCK_SIZE * NUM_BLOCKS);
+    ret = cBufferChainReadBytes(&chain, out, BLOCK_SIZE * NUM_BLOCKS);
+    assert(ret == BLOCK_SIZE * NUM_BLOCKS);
+    assert(memcmp(out, data, BLOCK_SIZE * NUM_BLOCKS) == 0);
+    assert(cBufferPoolAvailable(&pool) == NUM_BLOCKS);
+    printf("Test 3: Cleared chains and used the whole pool.\n");
+
+    printf("=== All tests passed! ===\n");
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer.h"
+#include "c_buffer_crc.h"
+
+#define MAIN_BUFFER_SIZE 64
+
+// Fletcher-16 as an example of a user checksum
+typedef struct {
+    uint16_t sum1;
+    uint16_t sum2;
+} fletcher16_t;
+
+static void fletcher16(void *state, const uint8_t *data, size_t size) {
+    fletcher16_t *f = (fletcher16_t *)state;
+    for (size_t i = 0; i < size; i++) {
+        f->sum1 = (f->sum1 + data[i]) % 255;
+        f->sum2 = (f->sum2 + f->sum1) % 255;
+    }
+}
+
+int main(void) {
+    int32_t ret;
+    uint32_t crc32;
+    uint16_t crc16;
+    cBuffer_t cb;
+    uint8_t buffer[MAIN_BUFFER_SIZE];
+
+    printf("=== Circular Buffer CRC Test Suite ===\n");
+
+    /********* Test 1: Check values across the wrap *********/
+    ret = cBufferInit(&cb, buffer, MAIN_BUFFER_SIZE);
+    assert(ret == C_BUFFER_SUCCESS);
+
+    // Place the check string so that it is split by the wrap, behind a two byte header
+    ret = cBufferEmptyWrite(&cb, MAIN_BUFFER_SIZE - 6);
+    assert(ret == MAIN_BUFFER_SIZE - 6);
+    ret = cBufferEmptyRead(&cb, MAIN_BUFFER_SIZE - 6);
+    assert(ret == MAIN_BUFFER_SIZE - 6);
+    ret = cBufferAppend(&cb, (uint8_t*)"HD123456789", 11);
+    assert(ret == 11);
+    assert(cBufferIsContigous(&cb) == C_BUFFER_WRAPED);
+
+    ret = cBufferCrc32(&cb, 2, 9, 0, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc32 == 0xCBF43926);
+
+    ret = cBufferCrc16(&cb, 2, 9, 0xFFFF, &crc16);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc16 == 0x29B1);
+    ret = cBufferCrc16(&cb, 2, 9, 0, &crc16);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc16 == 0x31C3);
+
+    // Continue a CRC over two ranges
+    ret = cBufferCrc32(&cb, 2, 3, 0, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferCrc32(&cb, 5, 6, crc32, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc32 == 0xCBF43926);
+
+    ret = cBufferCrc32(&cb, 3, 9, 0, &crc32);
+    assert(ret == C_BUFFER_MISMATCH);
+    ret = cBufferCrc32(&cb, 11, 0, 0, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc32 == 0);
+    assert(cBufferAvailableForRead(&cb) == 11);
+    printf("Test 1: CRC-32 0x%08X and CRC-16 check values across the wrap.\n", 0xCBF43926);
+
+    /********* Test 2: Long runs and user checksums *********/
+    uint8_t data[MAIN_BUFFER_SIZE - 1];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    ret = cBufferClear(&cb);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferAppend(&cb, data, 20);
+    assert(ret == 20);
+    ret = cBufferEmptyRead(&cb, 20);
+    assert(ret == 20);
+    ret = cBufferAppend(&cb, data, sizeof(data));
+    assert(ret == (int32_t)sizeof(data));
+
+    // The same CRC over the data in two pieces as in one
+    uint32_t whole;
+    ret = cBufferCrc32(&cb, 0, sizeof(data), 0, &whole);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferCrc32(&cb, 0, 41, 0, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferCrc32(&cb, 41, sizeof(data) - 41, crc32, &crc32);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(crc32 == whole);
+
+    fletcher16_t f = {0, 0};
+    ret = cBufferChecksum(&cb, 0, 5, fletcher16, &f);
+    assert(ret == C_BUFFER_SUCCESS);
+    fletcher16_t expected = {0, 0};
+    fletcher16(&expected, data, 5);
+    assert(f.sum1 == expected.sum1 && f.sum2 == expected.sum2);
+
+    f.sum1 = 0;
+    f.sum2 = 0;
+    ret = cBufferChecksum(&cb, 0, sizeof(data), fletcher16, &f);
+    assert(ret == C_BUFFER_SUCCESS);
+    expected.sum1 = 0;
+    expected.sum2 = 0;
+    fletcher16(&expected, data, sizeof(data));
+    assert(f.sum1 == expected.sum1 && f.sum2 == expected.sum2);
+    printf("Test 2: Split CRC and user checksum match the linear result.\n");
+
+    printf("=== All tests passed! ===\n");
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <array>
+#include "c_buffer.hpp"
+
+int main() {
+    int32_t ret;
+    CBuffer<16> cb;
+    std::array<uint8_t, 16> out{};
+
+    printf("=== Circular Buffer C++ Test Suite ===\n");
+
+    /********* Test 1: Bytes and spans *********/
+    static_assert(CBuffer<16>::capacity() == 16);
+    assert(cb.empty());
+
+    const uint8_t hello[] = {'H', 'e', 'l', 'l', 'o'};
+    ret = cb.append(hello);
+    assert(ret == 5);
+    ret = cb.appendByte('!');
+    assert(ret == 1);
+    assert(cb.size() == 6);
+    assert(cb.peekByte(1) == 'e');
+
+    ret = cb.read(std::span<uint8_t>(out.data(), 6));
+    assert(ret == 6);
+    assert(memcmp(out.data(), "Hello!", 6) == 0);
+    assert(cb.readByte() == 0);
+    printf("Test 1: Appended and read spans.\n");
+
+    /********* Test 2: Regions across the wrap *********/
+    {
+        const uint8_t fill[12] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L'};
+        ret = cb.append(fill);
+        assert(ret == 12);
+
+        // Ten bytes fit before the end of the array
+        auto [first, second] = cb.readRegions();
+        assert(first.size() == 10 && second.size() == 2);
+        assert(first[0] == 'A' && second[0] == 'K');
+
+        auto [to_first, to_second] = cb.writeRegions();
+        assert(to_first.size() == 4 && to_second.size() == 0);
+        to_first[0] = 'M';
+        ret = cb.commitWrite(1);
+        assert(ret == 1);
+
+        ret = cb.peek(11, std::span<uint8_t>(out.data(), 2));
+        assert(ret == 2);
+        assert(out[0] == 'L' && out[1] == 'M');
+        ret = cb.emptyRead(13);
+        assert(ret == 13);
+        assert(cb.empty());
+        ret = cb.append(std::span<const uint8_t>(fill, 12));
+        assert(ret == 12);
+        ret = cb.append(fill);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        printf("Test 2: Read and write regions as spans.\n");
+    }
+
+    /********* Test 3: Move *********/
+    {
+        CBuffer<16> moved(std::move(cb));
+        assert(cb.empty());
+        assert(moved.size() == 12);
+        assert(moved.get()->data != cb.get()->data);
+
+        CBuffer<16> assigned;
+        assigned.appendByte('X');
+        assigned = std::move(moved);
+        assert(assigned.size() == 12);
+        assert(assigned.readByte() == 'A');
+        assert(cBufferAvailableForRead(assigned.get()) == 11);
+        printf("Test 3: Moved the stored data to a new array.\n");
+    }
+
+    /********* Test 4: Move keeps the mode and headroom *********/
+    {
+        CBuffer<16> framed;
+        ret = cBufferReserveHeadroom(framed.get(), 4);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = framed.append(std::span<const uint8_t>((const uint8_t *)"DATA", 4));
+        assert(ret == 4);
+
+        CBuffer<16> moved(std::move(framed));
+        assert(moved.get()->headroom == 4);
+        ret = moved.prepend(std::span<const uint8_t>((const uint8_t *)"HDR:", 4));
+        assert(ret == 4);
+        assert(cBufferGetReadPointer(moved.get()) == moved.get()->data);
+        assert(memcmp(moved.get()->data, "HDR:DATA", 8) == 0);
+
+        CBuffer<16> spsc;
+        ret = cBufferInitSpsc(spsc.get(), spsc.get()->data, 16);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppendByte(spsc.get(), 'S');
+        assert(ret == 1);
+
+        CBuffer<16> spsc_moved;
+        spsc_moved = std::move(spsc);
+        assert(spsc_moved.get()->mode == spsc.get()->mode);
+        assert(cBufferReadByte(spsc_moved.get()) == 'S');
+        printf("Test 4: Moved buffers kept their mode and headroom.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
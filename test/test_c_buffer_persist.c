@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer.h"
+#include "c_buffer_persist.h"
+
+#define REGION_SIZE 1024
+
+// Stand ins for a retained RAM section before and after a reset
+static _Alignas(cBuffer_t) uint8_t region[REGION_SIZE];
+static _Alignas(cBuffer_t) uint8_t moved_region[REGION_SIZE];
+
+int main(void) {
+    int32_t ret;
+    cBuffer_t *cb;
+    uint8_t out[64];
+    cBufferPersistHeader_t *header = (cBufferPersistHeader_t *)region;
+
+    printf("=== Circular Buffer Persist Test Suite ===\n");
+
+    /********* Test 1: Format a region of garbage *********/
+    memset(region, 0xA5, sizeof(region));
+    ret = cBufferPersistOpen(region, sizeof(region), &cb);
+    assert(ret == 1);
+    assert(header->magic == C_BUFFER_PERSIST_MAGIC && header->generation == 1);
+    assert(cb->size == 512 && (cb->mode & C_BUFFER_MODE_SPSC));
+    assert((uint8_t *)cb > region && cb->data + cb->size <= region + sizeof(region));
+    assert(cBufferEmpty(cb) == 1);
+    printf("Test 1: Formatted a %zu byte data array.\n", cb->size);
+
+    /********* Test 2: Resume after a reset *********/
+    {
+        ret = cBufferAppend(cb, (uint8_t*)"boot;event A;", 13);
+        assert(ret == 13);
+        ret = cBufferReadBytes(cb, out, 5);
+        assert(ret == 5);
+        ret = cBufferAppend(cb, (uint8_t*)"event B;", 8);
+        assert(ret == 8);
+
+        // The region may show up at another address, e.g. a new file mapping
+        memcpy(moved_region, region, sizeof(region));
+        ret = cBufferPersistOpen(moved_region, sizeof(moved_region), &cb);
+        assert(ret == 0);
+        assert(cb->data > moved_region && cb->data < moved_region + sizeof(moved_region));
+        ret = cBufferReadAll(cb, out, sizeof(out));
+        assert(ret == 16);
+        assert(memcmp(out, "event A;event B;", 16) == 0);
+        printf("Test 2: Resumed the log at a new address.\n");
+    }
+
+    /********* Test 3: Broken indexes are formatted again *********/
+    {
+        ret = cBufferPersistOpen(region, sizeof(region), &cb);
+        assert(ret == 0);
+        cb->tail = cb->head - (cBufferIndex_t)cb->size - 1;
+        ret = cBufferPersistOpen(region, sizeof(region), &cb);
+        assert(ret == 1);
+        assert(header->generation == 2);
+        assert(cBufferEmpty(cb) == 1);
+
+        ret = cBufferPersistFormat(region, sizeof(region), &cb);
+        assert(ret == C_BUFFER_SUCCESS && header->generation == 3);
+        printf("Test 3: Invalid indexes started generation %u.\n", (unsigned)header->generation);
+    }
+
+    /********* Test 4: Region checks *********/
+    {
+        ret = cBufferPersistOpen(region, sizeof(cBufferPersistHeader_t), &cb);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferPersistOpen(region + 1, sizeof(region) - 1, &cb);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = cBufferPersistOpen(NULL, sizeof(region), &cb);
+        assert(ret == C_BUFFER_NULL_ERROR);
+        printf("Test 4: Rejected small and misaligned regions.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
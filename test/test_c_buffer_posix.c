@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "c_buffer.h"
+#include "c_buffer_posix.h"
+
+#define WAIT_TEST_BYTES 100000
+
+#ifdef __linux__
+typedef struct {
+    cBuffer_t     *cb;
+    cBufferWait_t *wait;
+} waitProducerArg_t;
+
+// Writes a counting pattern, sleeps on the futex when the buffer is full
+static void *waitProducer(void *arg) {
+    waitProducerArg_t *p = (waitProducerArg_t *)arg;
+    uint8_t chunk[8];
+    uint8_t value = 0;
+    int32_t ret;
+
+    for (int sent = 0; sent < WAIT_TEST_BYTES; sent += sizeof(chunk)) {
+        for (size_t ind = 0; ind < sizeof(chunk); ind++) {
+            chunk[ind] = value++;
+        }
+        ret = cBufferWaitWritable(p->wait, sizeof(chunk), 1000);
+        assert(ret >= (int32_t)sizeof(chunk));
+        ret = cBufferAppend(p->cb, chunk, sizeof(chunk));
+        assert(ret == sizeof(chunk));
+        cBufferNotifyReadable(p->wait);
+    }
+
+    return NULL;
+}
+#endif
+
+int main(void) {
+    int32_t ret;
+    int32_t available;
+    cBuffer_t cb;
+
+    printf("=== Circular Buffer POSIX Test Suite ===\n");
+
+    /********* Test 1: Mirrored buffer *********/
+    {
+        ret = cBufferInitMirrored(&cb, 100);
+        assert(ret == C_BUFFER_SUCCESS);
+        assert(cb.size >= 100 && (cb.size & (cb.size - 1)) == 0);
+        printf("Test 1: Initialized mirrored buffer (%zu bytes).\n", cb.size);
+
+        // The second mapping shows the same memory
+        cb.data[0] = 'M';
+        assert(cb.data[cb.size] == 'M');
+
+        // Move the data close to the end of the array so the next append wraps
+        size_t pos = cb.size - 3;
+        ret = cBufferCommitWrite(&cb, pos);
+        assert(ret == (int32_t)pos);
+        ret = cBufferEmptyRead(&cb, pos);
+        assert(ret == (int32_t)pos);
+
+        const char *data1 = "ABCDEFGH";
+        ret = cBufferAppend(&cb, (uint8_t*)data1, strlen(data1));
+        assert(ret == (int32_t)strlen(data1));
+
+        // The data wraps in the array but is contiguous through the mirror
+        assert(cBufferIsContigous(&cb) == C_BUFFER_SUCCESS);
+        uint8_t *read_ptr = cBufferGetReadPointer(&cb);
+        assert(read_ptr == &cb.data[pos]);
+        assert(memcmp(read_ptr, "ABCDEFGH", 8) == 0);
+        assert(memcmp(cb.data, "DEFGH", 5) == 0);
+
+        cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+        ret = cBufferGetReadRegions(&cb, regions);
+        assert(ret == 1 && regions[0].size == 8);
+
+        // Prepend across the wrap
+        ret = cBufferEmptyRead(&cb, 4);
+        assert(ret == 4);
+        ret = cBufferPrepend(&cb, (uint8_t*)"0123456", 7);
+        assert(ret == 7);
+        available = cBufferAvailableForRead(&cb);
+        assert(available == 11);
+        read_ptr = cBufferGetReadPointer(&cb);
+        assert(read_ptr != NULL && memcmp(read_ptr, "0123456EFGH", 11) == 0);
+
+        uint8_t out[16];
+        ret = cBufferReadBytes(&cb, out, 11);
+        assert(ret == 11);
+        out[ret] = '\0';
+        printf("Test 1: ReadBytes across the wrap returned \"%s\".\n", out);
+        assert(strcmp((char*)out, "0123456EFGH") == 0);
+
+        ret = cBufferDeinitMirrored(&cb);
+        assert(ret == C_BUFFER_SUCCESS);
+    }
+
+    /********* Test 2: File descriptor I/O across the wrap *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[10];
+        uint8_t out[16];
+        int fds[2];
+        ret = pipe(fds);
+        assert(ret == 0);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+        ret = cBufferInit(&cb_small, smallBuffer, sizeof(smallBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+
+        // Nothing to read yet
+        ret = cBufferReadFromFd(&cb_small, fds[0]);
+        assert(ret == C_BUFFER_WOULD_BLOCK);
+
+        // Move the tail so the free space wraps
+        ret = cBufferAppend(&cb_small, (uint8_t*)"ABCDEF", 6);
+        assert(ret == 6);
+        ret = cBufferEmptyRead(&cb_small, 6);
+        assert(ret == 6);
+
+        ret = write(fds[1], "0123456789", 10);
+        assert(ret == 10);
+        ret = cBufferReadFromFd(&cb_small, fds[0]);
+        assert(ret == 9);
+        assert(cBufferIsContigous(&cb_small) == C_BUFFER_WRAPED);
+        ret = cBufferReadFromFd(&cb_small, fds[0]);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        // Write both regions back out in one call
+        ret = cBufferWriteToFd(&cb_small, fds[1]);
+        assert(ret == 9);
+        assert(cBufferEmpty(&cb_small) == 1);
+        ret = cBufferWriteToFd(&cb_small, fds[1]);
+        assert(ret == 0);
+
+        ret = read(fds[0], out, sizeof(out));
+        assert(ret == 10);
+        out[ret] = '\0';
+        printf("Test 2: Pipe returned \"%s\".\n", out);
+        assert(strcmp((char*)out, "9012345678") == 0);
+
+        // End of file is reported as zero bytes read
+        close(fds[1]);
+        ret = cBufferReadFromFd(&cb_small, fds[0]);
+        assert(ret == 0);
+        close(fds[0]);
+    }
+
+#ifdef __linux__
+    /********* Test 3: Futex wait hooks *********/
+    {
+        cBuffer_t cb_spsc;
+        uint8_t spscBuffer[64];
+        uint8_t out[32];
+        cBufferWait_t wait;
+        pthread_t thread;
+        uint8_t expected = 0;
+
+        ret = cBufferInitSpsc(&cb_spsc, spscBuffer, sizeof(spscBuffer));
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferWaitInit(&wait, &cb_spsc, &cBufferWaitFutexHooks);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferWaitReadable(&wait, 1, 1);
+        assert(ret == C_BUFFER_WOULD_BLOCK);
+
+        waitProducerArg_t arg = {&cb_spsc, &wait};
+        pthread_create(&thread, NULL, waitProducer, &arg);
+
+        for (int received = 0; received < WAIT_TEST_BYTES; received += sizeof(out)) {
+            ret = cBufferWaitReadable(&wait, sizeof(out), 1000);
+            assert(ret >= (int32_t)sizeof(out));
+            ret = cBufferReadBytes(&cb_spsc, out, sizeof(out));
+            assert(ret == sizeof(out));
+            cBufferNotifyWritable(&wait);
+
+            for (size_t ind = 0; ind < sizeof(out); ind++) {
+                assert(out[ind] == expected++);
+            }
+        }
+
+        pthread_join(thread, NULL);
+        assert(cBufferEmpty(&cb_spsc) == 1);
+        printf("Test 3: Futex waits moved %d bytes.\n", WAIT_TEST_BYTES);
+    }
+#endif
+
+    /********* Test 4: Persistent buffer in a file *********/
+    {
+        char path[] = "/tmp/c_buffer_persistXXXXXX";
+        int fd = mkstemp(path);
+        assert(fd >= 0);
+        close(fd);
+
+        void *region;
+        cBuffer_t *cb_log;
+        uint8_t out[16];
+        ret = cBufferPersistMapFile(path, 4096, &region);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferPersistOpen(region, 4096, &cb_log);
+        assert(ret == 1);
+        ret = cBufferAppend(cb_log, (uint8_t*)"kept", 4);
+        assert(ret == 4);
+        ret = cBufferPersistFlush(region, 4096);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferPersistUnmapFile(region, 4096);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferPersistMapFile(path, 4096, &region);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferPersistOpen(region, 4096, &cb_log);
+        assert(ret == 0);
+        ret = cBufferReadAll(cb_log, out, sizeof(out));
+        assert(ret == 4 && memcmp(out, "kept", 4) == 0);
+        ret = cBufferPersistUnmapFile(region, 4096);
+        assert(ret == C_BUFFER_SUCCESS);
+        unlink(path);
+        printf("Test 4: Reopened the mapped file with its data.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer.h"
+#include "c_buffer_record.h"
+
+#define MAIN_BUFFER_SIZE 256
+#define SMALL_BUFFER_SIZE 16
+
+int main(void) {
+    int32_t ret;
+    uint8_t out[MAIN_BUFFER_SIZE];
+    cBuffer_t cb;
+    uint8_t buffer[MAIN_BUFFER_SIZE];
+
+    printf("=== Circular Buffer Record Test Suite ===\n");
+
+    /********* Test 1: Push and pop records *********/
+    ret = cBufferInit(&cb, buffer, MAIN_BUFFER_SIZE);
+    assert(ret == C_BUFFER_SUCCESS);
+
+    ret = cBufferPeekRecordLen(&cb);
+    assert(ret == C_BUFFER_MISMATCH);
+
+    ret = cBufferPushRecord(&cb, (uint8_t*)"Hello", 5);
+    assert(ret == 5);
+    ret = cBufferPushRecord(&cb, NULL, 0);
+    assert(ret == 0);
+
+    // A payload of 200 bytes needs a two byte header
+    uint8_t large[200];
+    memset(large, 'L', sizeof(large));
+    assert(cBufferRecordSize(sizeof(large)) == sizeof(large) + 2);
+    ret = cBufferPushRecord(&cb, large, sizeof(large));
+    assert(ret == (int32_t)sizeof(large));
+    assert(cBufferAvailableForRead(&cb) == 6 + 1 + 202);
+
+    ret = cBufferPeekRecordLen(&cb);
+    assert(ret == 5);
+    ret = cBufferPopRecord(&cb, out, 4);
+    assert(ret == C_BUFFER_INSUFFICIENT);
+    ret = cBufferPopRecord(&cb, out, sizeof(out));
+    assert(ret == 5);
+    out[ret] = '\0';
+    assert(strcmp((char*)out, "Hello") == 0);
+    printf("Test 1: Popped record \"%s\".\n", out);
+
+    ret = cBufferPopRecord(&cb, out, sizeof(out));
+    assert(ret == 0);
+    ret = cBufferPeekRecordLen(&cb);
+    assert(ret == (int32_t)sizeof(large));
+    ret = cBufferPopRecord(&cb, out, sizeof(out));
+    assert(ret == (int32_t)sizeof(large));
+    assert(memcmp(out, large, sizeof(large)) == 0);
+    assert(cBufferEmpty(&cb) == 1);
+
+    /********* Test 2: Records are written completely or not at all *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"ABCDEFGHIJ", 10);
+        assert(ret == 10);
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"KLMNO", 5);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        assert(cBufferAvailableForRead(&cb_small) == 11);
+
+        // A partial record is never reported
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferAppend(&cb_small, (uint8_t*)"\x05" "AB", 3);
+        assert(ret == 3);
+        ret = cBufferPeekRecordLen(&cb_small);
+        assert(ret == C_BUFFER_MISMATCH);
+        printf("Test 2: Partial records are refused.\n");
+    }
+
+    /********* Test 3: Zero copy pop across the wrap *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        cBufferRegion_t regions[C_BUFFER_NUM_REGIONS];
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"ABCDEFGHIJ", 10);
+        assert(ret == 10);
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"KLMNOPQ", 7);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = cBufferPopRecordZeroCopy(&cb_small, regions);
+        assert(ret == 10);
+        assert(regions[0].size == 10 && regions[1].size == 0);
+        assert(memcmp(regions[0].data, "ABCDEFGHIJ", 10) == 0);
+        ret = cBufferEmptyRead(&cb_small, 10);
+        assert(ret == 10);
+
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"KLMNOPQ", 7);
+        assert(ret == 7);
+        ret = cBufferPushRecord(&cb_small, (uint8_t*)"RS", 2);
+        assert(ret == 2);
+        ret = cBufferPopRecordZeroCopy(&cb_small, regions);
+        assert(ret == 7);
+        assert(regions[0].size == 4 && regions[1].size == 3);
+        assert(memcmp(regions[0].data, "KLMN", 4) == 0);
+        assert(memcmp(regions[1].data, "OPQ", 3) == 0);
+        ret = cBufferEmptyRead(&cb_small, 7);
+        assert(ret == 7);
+
+        ret = cBufferPopRecordZeroCopy(&cb_small, regions);
+        assert(ret == 2);
+        assert(regions[0].size == 2 && regions[1].size == 0);
+        assert(memcmp(regions[0].data, "RS", 2) == 0);
+        ret = cBufferEmptyRead(&cb_small, 2);
+        assert(ret == 2);
+        assert(cBufferEmpty(&cb_small) == 1);
+        printf("Test 3: Zero copy pop returned the payload regions.\n");
+    }
+
+    /********* Test 4: Overwrite the oldest records *********/
+    {
+        cBuffer_t cb_small;
+        uint8_t smallBuffer[SMALL_BUFFER_SIZE];
+        size_t dropped;
+        ret = cBufferInit(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+
+        ret = cBufferPushRecordOverwrite(&cb_small, (uint8_t*)"ABCD", 4, &dropped);
+        assert(ret == 4 && dropped == 0);
+        ret = cBufferPushRecordOverwrite(&cb_small, (uint8_t*)"EFGH", 4, &dropped);
+        assert(ret == 4 && dropped == 0);
+        ret = cBufferPushRecordOverwrite(&cb_small, (uint8_t*)"IJ", 2, &dropped);
+        assert(ret == 2 && dropped == 0);
+
+        // Only two bytes are free, the whole first record must go
+        ret = cBufferPushRecordOverwrite(&cb_small, (uint8_t*)"KLMNO", 5, &dropped);
+        assert(ret == 5 && dropped == 1);
+        ret = cBufferPushRecordOverwrite(&cb_small, out, SMALL_BUFFER_SIZE, &dropped);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        ret = cBufferPopRecord(&cb_small, out, sizeof(out));
+        assert(ret == 4 && memcmp(out, "EFGH", 4) == 0);
+        ret = cBufferPopRecord(&cb_small, out, sizeof(out));
+        assert(ret == 2 && memcmp(out, "IJ", 2) == 0);
+        ret = cBufferPopRecord(&cb_small, out, sizeof(out));
+        assert(ret == 5 && memcmp(out, "KLMNO", 5) == 0);
+        assert(cBufferEmpty(&cb_small) == 1);
+
+        ret = cBufferInitSpsc(&cb_small, smallBuffer, SMALL_BUFFER_SIZE);
+        assert(ret == C_BUFFER_SUCCESS);
+        ret = cBufferPushRecordOverwrite(&cb_small, (uint8_t*)"ABCD", 4, &dropped);
+        assert(ret == C_BUFFER_MISMATCH);
+        printf("Test 4: Overwrite dropped whole records only.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
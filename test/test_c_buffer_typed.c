@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer_typed.h"
+
+#define SAMPLE_RING_SIZE 8
+
+typedef struct {
+    uint32_t time;
+    int16_t  value;
+} sample_t;
+
+C_BUFFER_DEFINE(sampleRing, sample_t)
+C_BUFFER_DEFINE(adcRing, uint16_t)
+
+int main(void) {
+    int32_t ret;
+    sampleRing_t ring;
+    sample_t samples[SAMPLE_RING_SIZE];
+    sample_t sample;
+
+    printf("=== Circular Buffer Typed Test Suite ===\n");
+
+    /********* Test 1: Push and pop elements *********/
+    ret = sampleRingInit(&ring, samples, 6);
+    assert(ret == C_BUFFER_MISMATCH);
+    ret = sampleRingInit(&ring, samples, SAMPLE_RING_SIZE);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(sampleRingAvailableForWrite(&ring) == SAMPLE_RING_SIZE);
+
+    for (int ind = 0; ind < SAMPLE_RING_SIZE; ind++) {
+        sample.time  = ind;
+        sample.value = (int16_t)(-ind);
+        ret = sampleRingPush(&ring, &sample);
+        assert(ret == C_BUFFER_SUCCESS);
+    }
+    ret = sampleRingPush(&ring, &sample);
+    assert(ret == C_BUFFER_INSUFFICIENT);
+    assert(sampleRingAvailableForRead(&ring) == SAMPLE_RING_SIZE);
+
+    ret = sampleRingPeek(&ring, 2, &sample);
+    assert(ret == C_BUFFER_SUCCESS && sample.time == 2);
+    ret = sampleRingPop(&ring, &sample);
+    assert(ret == C_BUFFER_SUCCESS);
+    assert(sample.time == 0 && sample.value == 0);
+    printf("Test 1: Pushed and popped whole elements.\n");
+
+    /********* Test 2: Bulk across the wrap *********/
+    {
+        sample_t bulk[5];
+        sampleRingRegion_t regions[C_BUFFER_NUM_REGIONS];
+
+        ret = sampleRingPopBulk(&ring, bulk, 5);
+        assert(ret == 5);
+        assert(bulk[0].time == 1 && bulk[4].time == 5);
+
+        // Two elements are left at the end of the array, the new ones go after the wrap
+        for (int ind = 0; ind < 5; ind++) {
+            bulk[ind].time  = 100 + ind;
+            bulk[ind].value = (int16_t)ind;
+        }
+        ret = sampleRingPushBulk(&ring, bulk, 5);
+        assert(ret == 5);
+        ret = sampleRingPushBulk(&ring, bulk, 2);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+
+        ret = sampleRingGetReadRegions(&ring, regions);
+        assert(ret == 2);
+        assert(regions[0].size == 2 && regions[1].size == 5);
+        assert(regions[0].data[0].time == 6 && regions[1].data[0].time == 100);
+        ret = sampleRingEmptyRead(&ring, 3);
+        assert(ret == 3);
+
+        ret = sampleRingPopBulk(&ring, bulk, 5);
+        assert(ret == C_BUFFER_MISMATCH);
+        ret = sampleRingPopBulk(&ring, bulk, 4);
+        assert(ret == 4);
+        assert(bulk[0].time == 101 && bulk[3].time == 104);
+        assert(sampleRingAvailableForRead(&ring) == 0);
+        ret = sampleRingPop(&ring, &sample);
+        assert(ret == C_BUFFER_MISMATCH);
+        printf("Test 2: Bulk push and pop across the wrap.\n");
+    }
+
+    /********* Test 3: Write regions *********/
+    {
+        adcRing_t adc;
+        uint16_t readings[4];
+        adcRingRegion_t regions[C_BUFFER_NUM_REGIONS];
+        uint16_t reading;
+
+        ret = adcRingInit(&adc, readings, 4);
+        assert(ret == C_BUFFER_SUCCESS);
+        reading = 1;
+        adcRingPush(&adc, &reading);
+        adcRingPush(&adc, &reading);
+        adcRingPop(&adc, &reading);
+
+        ret = adcRingGetWriteRegions(&adc, regions);
+        assert(ret == 2);
+        assert(regions[0].size == 2 && regions[1].size == 1);
+        regions[0].data[0] = 0x100;
+        regions[0].data[1] = 0x200;
+        regions[1].data[0] = 0x300;
+        ret = adcRingCommitWrite(&adc, 4);
+        assert(ret == C_BUFFER_INSUFFICIENT);
+        ret = adcRingCommitWrite(&adc, 3);
+        assert(ret == 3);
+
+        ret = adcRingGetWriteRegions(&adc, regions);
+        assert(ret == 0 && regions[0].data == NULL);
+        adcRingPop(&adc, &reading);
+        assert(reading == 1);
+        adcRingPop(&adc, &reading);
+        assert(reading == 0x100);
+        assert(adcRingClear(&adc) == C_BUFFER_SUCCESS);
+        assert(adcRingAvailableForRead(&adc) == 0);
+        printf("Test 3: Filled the free regions in place.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
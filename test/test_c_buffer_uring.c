@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include "c_buffer.h"
+#include "c_buffer_uring.h"
+
+#define MAIN_BUFFER_SIZE 16
+
+typedef struct {
+    int     num_reads;
+    int     num_writes;
+    int32_t total;
+} completions_t;
+
+static void onComplete(void *ctx, cBuffer_t *inst, int is_write, int32_t res) {
+    completions_t *c = (completions_t *)ctx;
+    (void)inst;
+    assert(res >= 0);
+
+    if (is_write) {
+        c->num_writes++;
+    } else {
+        c->num_reads++;
+    }
+    c->total += res;
+}
+
+int main(void) {
+    int32_t ret;
+    cBufferUring_t ring;
+    cBuffer_t cb;
+    uint8_t buffer[MAIN_BUFFER_SIZE];
+    uint8_t out[MAIN_BUFFER_SIZE];
+    completions_t completions = {0};
+    int in_fds[2];
+    int out_fds[2];
+
+    printf("=== Circular Buffer io_uring Test Suite ===\n");
+
+    // Containers and old kernels often block io_uring
+    ret = cBufferUringInit(&ring, 8);
+    if (ret != C_BUFFER_SUCCESS) {
+        printf("io_uring is not available, skipping.\n");
+        return 0;
+    }
+
+    ret = cBufferInitSpsc(&cb, buffer, MAIN_BUFFER_SIZE);
+    assert(ret == C_BUFFER_SUCCESS);
+    cBuffer_t *buffers[] = {&cb};
+    ret = cBufferUringRegister(&ring, buffers, 1);
+    assert(ret == C_BUFFER_SUCCESS);
+
+    /********* Test 1: Read into both free regions *********/
+    ret = pipe(in_fds);
+    assert(ret == 0);
+
+    // Move the indexes so the free space wraps after four bytes
+    ret = cBufferEmptyWrite(&cb, 12);
+    assert(ret == 12);
+    ret = cBufferEmptyRead(&cb, 12);
+    assert(ret == 12);
+
+    ret = write(in_fds[1], "0123456789", 10);
+    assert(ret == 10);
+    ret = cBufferUringQueueRead(&ring, &cb, 0, in_fds[0]);
+    assert(ret == 2);
+    ret = cBufferUringSubmit(&ring, 2);
+    assert(ret == 2);
+    ret = cBufferUringComplete(&ring, onComplete, &completions);
+    assert(ret == 2);
+    assert(completions.num_reads == 2 && completions.total == 10);
+    assert(cBufferIsContigous(&cb) == C_BUFFER_WRAPED);
+
+    ret = cBufferPeek(&cb, 0, out, 10);
+    assert(ret == 10);
+    assert(memcmp(out, "0123456789", 10) == 0);
+    printf("Test 1: Linked fixed reads filled both regions.\n");
+
+    /********* Test 2: Write both data regions *********/
+    {
+        ret = pipe(out_fds);
+        assert(ret == 0);
+
+        completions.total = 0;
+        ret = cBufferUringQueueWrite(&ring, &cb, 0, out_fds[1]);
+        assert(ret == 2);
+        ret = cBufferUringSubmit(&ring, 2);
+        assert(ret == 2);
+        ret = cBufferUringComplete(&ring, onComplete, &completions);
+        assert(ret == 2);
+        assert(completions.num_writes == 2 && completions.total == 10);
+        assert(cBufferEmpty(&cb) == 1);
+
+        ret = read(out_fds[0], out, sizeof(out));
+        assert(ret == 10);
+        assert(memcmp(out, "0123456789", 10) == 0);
+
+        // Nothing to write
+        ret = cBufferUringQueueWrite(&ring, &cb, 0, out_fds[1]);
+        assert(ret == 0);
+        printf("Test 2: Linked fixed writes drained the buffer.\n");
+    }
+
+    close(in_fds[0]);
+    close(in_fds[1]);
+    close(out_fds[0]);
+    close(out_fds[1]);
+    ret = cBufferUringDeinit(&ring);
+    assert(ret == C_BUFFER_SUCCESS);
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}
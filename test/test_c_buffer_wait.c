@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "c_buffer.h"
+#include "c_buffer_wait.h"
+
+#define MAIN_BUFFER_SIZE 16
+
+// Hooks that play the other side from inside the wait, so the test runs in one thread
+typedef struct {
+    cBufferWait_t *wait;
+    cBuffer_t     *cb;
+    int            num_waits;
+    int            num_wakes;
+    int            reader;
+} fakeSide_t;
+
+static int32_t fakeWait(void *ctx, uint32_t *word, uint32_t expected, int32_t timeout_ms) {
+    fakeSide_t *side = (fakeSide_t *)ctx;
+    (void)word;
+    (void)expected;
+    (void)timeout_ms;
+
+    side->num_waits++;
+    if (side->num_waits > 4) {
+        return C_BUFFER_WOULD_BLOCK;
+    }
+
+    // Two bytes per sleep, the other side notifies after every step
+    if (side->reader) {
+        uint8_t out[2];
+        cBufferReadBytes(side->cb, out, 2);
+        cBufferNotifyWritable(side->wait);
+    } else {
+        cBufferAppend(side->cb, (uint8_t*)"AB", 2);
+        cBufferNotifyReadable(side->wait);
+    }
+
+    return C_BUFFER_SUCCESS;
+}
+
+static void fakeWake(void *ctx, uint32_t *word) {
+    fakeSide_t *side = (fakeSide_t *)ctx;
+    (void)word;
+    side->num_wakes++;
+}
+
+int main(void) {
+    int32_t ret;
+    cBuffer_t cb;
+    uint8_t buffer[MAIN_BUFFER_SIZE];
+    cBufferWait_t wait;
+    fakeSide_t side = {0};
+    cBufferWaitHooks_t hooks = {fakeWait, fakeWake, &side};
+
+    printf("=== Circular Buffer Wait Test Suite ===\n");
+
+    /********* Test 1: Wait for readable data *********/
+    ret = cBufferInitSpsc(&cb, buffer, MAIN_BUFFER_SIZE);
+    assert(ret == C_BUFFER_SUCCESS);
+    ret = cBufferWaitInit(&wait, &cb, &hooks);
+    assert(ret == C_BUFFER_SUCCESS);
+    side.wait = &wait;
+    side.cb   = &cb;
+
+    ret = cBufferWaitReadable(&wait, 4, 0);
+    assert(ret == C_BUFFER_WOULD_BLOCK);
+    assert(side.num_waits == 0 && wait.read_want == 0);
+    assert(cBufferWaitReadable(&wait, 0, 10) == C_BUFFER_MISMATCH);
+    assert(cBufferWaitReadable(&wait, MAIN_BUFFER_SIZE + 1, 10) == C_BUFFER_MISMATCH);
+
+    // The first two bytes are below the threshold and must not wake the consumer
+    ret = cBufferWaitReadable(&wait, 4, 10);
+    assert(ret == 4);
+    assert(side.num_waits == 2 && side.num_wakes == 1);
+    assert(wait.read_want == 0);
+
+    // Nobody waits, so nobody is woken
+    ret = cBufferNotifyReadable(&wait);
+    assert(ret == C_BUFFER_SUCCESS && side.num_wakes == 1);
+    printf("Test 1: Consumer was woken once at the threshold.\n");
+
+    /********* Test 2: Wait for free space *********/
+    {
+        ret = cBufferAppend(&cb, (uint8_t*)"CDEFGHIJKLMN", 12);
+        assert(ret == 12);
+        assert(cBufferAvailableForWrite(&cb) == 0);
+
+        side.num_waits = 0;
+        side.num_wakes = 0;
+        side.reader    = 1;
+        ret = cBufferWaitWritable(&wait, 6, -1);
+        assert(ret == 6);
+        assert(side.num_waits == 3 && side.num_wakes == 1);
+        printf("Test 2: Producer was woken once when space was freed.\n");
+    }
+
+    /********* Test 3: Timeout *********/
+    {
+        side.num_waits = 4;
+        ret = cBufferWaitWritable(&wait, MAIN_BUFFER_SIZE, 10);
+        assert(ret == C_BUFFER_WOULD_BLOCK);
+        assert(wait.write_want == 0);
+        printf("Test 3: Wait returned on timeout.\n");
+    }
+
+    printf("=== All tests passed! ===\n");
+    return 0;
+}